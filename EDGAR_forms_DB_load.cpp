@@ -128,12 +128,12 @@ int main(int argc, const char *argv[])
                                           ? static_cast<size_t>(program_options.max_concurrent_loads_)
                                           : std::min(static_cast<size_t>(4), files_to_scan.size());
 
-        // Ensure DB pool size is AT LEAST equal to max_concurrent to avoid thread starvation
-        const size_t base_pool_size =
-            std::clamp(files_to_scan.size() / 4, static_cast<size_t>(1), static_cast<size_t>(8));
-        const size_t pool_size = std::max(max_concurrent, base_pool_size);
+        // each worker holds at most 1 connection so the pool never needs more than
+        // max_concurrent. start small and let the pool grow when workers have to wait
+        // for a connection. extras which sit idle are closed again.
 
-        DatabasePool db_pool{"dbname=sec_extracts user=extractor_pg", pool_size};
+        DatabasePool db_pool{"dbname=sec_extracts user=extractor_pg", 1, {},
+                             ConnectionQueue::AdaptiveSizing{.max_size_ = std::max(max_concurrent, size_t{1})}};
         db_pool.test_connection();
 
         // Set up signal handler
@@ -188,12 +188,11 @@ int main(int argc, const char *argv[])
             // Parallel processing with controlled concurrency
             spdlog::info("Processing {} files in parallel (max {} concurrent).", files_to_scan.size(), max_concurrent);
             worker_pool.submit_all(files_to_scan, scan_file);
-
-            // Log pool statistics after processing
-            spdlog::info("Database pool statistics: {} connections in pool, {} available", pool_size,
-                         db_pool.available_count());
         }
 
+        // Log pool statistics after processing
+        db_pool.log_stats();
+
         // Cleanly join the watcher thread before exiting
         g_shutdown_requested.store(true, std::memory_order_relaxed); // Ensure the watcher loop exits
         if (signal_watcher.joinable())
@@ -549,8 +548,8 @@ void LoadSingleFileToDB(const Options &program_options, const CIK2SymbolMap &CIK
             return;
         }
 
-        const std::string content{LoadDataFileForUse(input_file_name)};
-        EM::FileContent file_content{content};
+        const MappedFile mapped_file{input_file_name};
+        EM::FileContent file_content{mapped_file.GetContent()};
         const auto document_sections = LocateDocumentSections(file_content);
 
         SEC_Header SEC_data;
@@ -0,0 +1,219 @@
+// =====================================================================================
+//
+//       Filename:  copy_bench.cpp
+//
+//    Description:  times loading an instance document's facts with
+//                  pqxx::stream_to and with CopyTextWriter.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 10:14:38 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+// the facts are written the way LoadDataToDB writes sec_xbrl_data but into a
+// temp table with the same column types, inside a transaction which is rolled
+// back, so nothing is left in the DB. there is no label linkbase here so the
+// XBRL label is used for both labels. --repeat writes each fact that many
+// times to make a bigger load out of 1 document.
+// the 2 ways take turns and the best of --runs counts for each. the first run
+// checks both leave the same table contents.
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include <boost/program_options.hpp>
+
+#include <pqxx/pqxx>
+
+#include <spdlog/spdlog.h>
+
+#include "CopyTextWriter.h"
+#include "Extractor_Utils.h"
+#include "XBRL_InstanceReader.h"
+
+namespace po = boost::program_options;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr const char *k_create_table{
+    "CREATE TEMP TABLE copy_bench (filing_id BIGINT, xbrl_label TEXT NOT NULL, label TEXT NOT NULL,"
+    " value NUMERIC(20, 4) NOT NULL, context_id TEXT NOT NULL, period_begin DATE NOT NULL,"
+    " period_end DATE NOT NULL, units TEXT NOT NULL, decimals TEXT)"};
+
+constexpr const char *k_table_digest{
+    "SELECT md5(string_agg(b::TEXT, E'\\n' ORDER BY b::TEXT)) FROM copy_bench b"};
+
+const std::string k_filing_ID{"1"};
+
+std::string ReadFile(const fs::path &file_name)
+{
+    std::ifstream file{file_name, std::ios::in | std::ios::binary};
+    if (!file)
+    {
+        throw std::runtime_error(catenate("Can't open: ", file_name.string()));
+    }
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+// calls write_row with each row's fields, 'repeat' times over.
+
+template <typename WriteRow> void ForEachRow(const XBRL_InstanceData &instance_data, int repeat, WriteRow write_row)
+{
+    for (int i = 0; i < repeat; ++i)
+    {
+        for (const auto &[label, context_ID, units, decimals, value] : instance_data.gaap_data_)
+        {
+            const auto &period = instance_data.context_data_.at(context_ID);
+            write_row(k_filing_ID, label, label, value, context_ID, period.begin, period.end, units, decimals);
+        }
+    }
+}
+
+struct LoadResult
+{
+    double seconds_;
+    std::string digest_;
+};
+
+template <typename Load>
+LoadResult TimeLoad(pqxx::connection &conn, size_t expected_rows, bool want_digest, Load load)
+{
+    pqxx::work trxn{conn};
+    trxn.exec(k_create_table);
+
+    const auto start = std::chrono::steady_clock::now();
+    load(trxn);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const auto rows = trxn.query_value<size_t>("SELECT count(*) FROM copy_bench");
+    if (rows != expected_rows)
+    {
+        throw std::runtime_error(catenate("Loaded: ", rows, " rows. expected: ", expected_rows));
+    }
+    LoadResult result{seconds, want_digest ? trxn.query_value<std::string>(k_table_digest) : std::string{}};
+    trxn.abort();
+    return result;
+}
+
+int Benchmark(const std::string &DB_connection, const fs::path &file_name, int runs, int repeat)
+{
+    const auto document = ReadFile(file_name);
+    const auto instance_data = ExtractInstanceData(EM::XBRLContent{EM::sv{document}});
+    const size_t expected_rows = instance_data.gaap_data_.size() * static_cast<size_t>(repeat);
+    if (expected_rows == 0)
+    {
+        throw std::runtime_error(catenate("No facts found in: ", file_name.string()));
+    }
+
+    pqxx::connection conn{DB_connection};
+
+    auto with_stream_to = [&](pqxx::work &trxn) {
+        auto inserter{pqxx::stream_to::table(trxn, {"copy_bench"},
+                                             {"filing_id", "xbrl_label", "label", "value", "context_id",
+                                              "period_begin", "period_end", "units", "decimals"})};
+        ForEachRow(instance_data, repeat, [&inserter](const auto &...fields) { inserter.write_values(fields...); });
+        inserter.complete();
+    };
+    auto with_copy_text = [&](pqxx::work &trxn) {
+        CopyTextWriter inserter{trxn,
+                                {"copy_bench"},
+                                {"filing_id", "xbrl_label", "label", "value", "context_id", "period_begin",
+                                 "period_end", "units", "decimals"}};
+        ForEachRow(instance_data, repeat, [&inserter](const auto &...fields) { inserter.WriteRow(fields...); });
+        inserter.Complete();
+    };
+
+    double stream_to_best{1e9};
+    double copy_text_best{1e9};
+    for (int i = 0; i < runs; ++i)
+    {
+        const bool check = i == 0;
+        const auto stream_to = TimeLoad(conn, expected_rows, check, with_stream_to);
+        const auto copy_text = TimeLoad(conn, expected_rows, check, with_copy_text);
+        if (check && stream_to.digest_ != copy_text.digest_)
+        {
+            std::cerr << "stream_to and CopyTextWriter loaded different table contents.\n";
+            return 1;
+        }
+        stream_to_best = std::min(stream_to_best, stream_to.seconds_);
+        copy_text_best = std::min(copy_text_best, copy_text.seconds_);
+    }
+
+    const auto rows = static_cast<double>(expected_rows);
+    std::cout << std::format("{}: {} facts x {} = {} rows. table contents match.\n", file_name.string(),
+                             instance_data.gaap_data_.size(), repeat, expected_rows);
+    std::cout << std::format("  stream_to:      {:12.0f} rows/s\n", rows / stream_to_best);
+    std::cout << std::format("  CopyTextWriter: {:12.0f} rows/s ({:.2f}x)\n", rows / copy_text_best,
+                             stream_to_best / copy_text_best);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, const char *argv[])
+{
+    std::string DB_connection;
+    std::string file_name;
+    int runs{5};
+    int repeat{1};
+
+    po::options_description options{"copy_bench options"};
+    options.add_options()("help,h", "produce help message")(
+        "DB-connection", po::value<std::string>(&DB_connection)->default_value("dbname=sec_extracts user=extractor_pg"),
+        "libpq connection string for the DB to time against. nothing is left in it")(
+        "file", po::value<std::string>(&file_name), "instance document to load")(
+        "runs", po::value<int>(&runs)->default_value(5), "loads with each writer. the best one counts")(
+        "repeat", po::value<int>(&repeat)->default_value(1), "write each fact this many times");
+
+    po::positional_options_description positional;
+    positional.add("file", 1);
+
+    try
+    {
+        po::variables_map variable_map;
+        po::store(po::command_line_parser(argc, argv).options(options).positional(positional).run(), variable_map);
+        po::notify(variable_map);
+        if (variable_map.count("help") != 0 || file_name.empty())
+        {
+            std::cout << "copy_bench [options] instance_document\n" << options << '\n';
+            return file_name.empty() ? 1 : 0;
+        }
+
+        spdlog::set_level(spdlog::level::warn);
+
+        return Benchmark(DB_connection, file_name, std::max(runs, 1), std::max(repeat, 1));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Problem: " << e.what() << '\n';
+    }
+    return 1;
+}
@@ -121,3 +121,17 @@ CREATE INDEX idx_xbrl_data ON test_unified_extracts.sec_xbrl_data (filing_id);
 
 DROP INDEX IF EXISTS idx_xbrl_period_end;
 CREATE INDEX idx_xbrl_period_end ON test_unified_extracts.sec_xbrl_data (period_end);
+
+-- indexes dropped by a --bulk-load run wait here until they are rebuilt.
+-- recreating the tables above also recreates their indexes so anything left
+-- here is stale.
+
+DROP TABLE IF EXISTS test_unified_extracts.deferred_indexes;
+
+CREATE TABLE test_unified_extracts.deferred_indexes
+(
+    index_name TEXT PRIMARY KEY,
+    index_def TEXT NOT NULL
+);
+
+ALTER TABLE test_unified_extracts.deferred_indexes OWNER TO extractor_pg;
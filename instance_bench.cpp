@@ -0,0 +1,251 @@
+// =====================================================================================
+//
+//       Filename:  instance_bench.cpp
+//
+//    Description:  times the DOM and expat ways of reading XBRL instance
+//                  documents and measures the memory each needs.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 09:26:53 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+// each file is an instance document pulled out of a filing. each way of reading
+// it runs in its own child process so getrusage gives the peak memory of just
+// that way. a child which only touches the document gives the starting point
+// the others are measured from. speed is the best of --runs passes.
+// the 2 results are compared the same as --verify-instance-reader does.
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include "Extractor_Utils.h"
+#include "Extractor_XBRL_FileFilter.h"
+#include "XBRL_InstanceReader.h"
+
+namespace po = boost::program_options;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+struct ChildResult
+{
+    double seconds_;
+    long max_RSS_KB_;
+};
+
+std::string ReadFile(const fs::path &file_name)
+{
+    std::ifstream file{file_name, std::ios::in | std::ios::binary};
+    if (!file)
+    {
+        throw std::runtime_error(catenate("Can't open: ", file_name.string()));
+    }
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+// function returns how long its best pass took.
+
+template <typename Function>
+ChildResult RunInChild(Function function)
+{
+    std::array<int, 2> result_pipe{};
+    if (pipe(result_pipe.data()) != 0)
+    {
+        throw std::runtime_error("Can't make pipe for child.");
+    }
+
+    const pid_t child = fork();
+    if (child < 0)
+    {
+        throw std::runtime_error("Can't start child.");
+    }
+    if (child == 0)
+    {
+        close(result_pipe[0]);
+        int status{0};
+        try
+        {
+            const double seconds = function();
+            if (write(result_pipe[1], &seconds, sizeof(seconds)) != sizeof(seconds))
+            {
+                status = 1;
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Problem: " << e.what() << '\n';
+            status = 1;
+        }
+        _exit(status);
+    }
+
+    close(result_pipe[1]);
+    double seconds{0};
+    const auto got = read(result_pipe[0], &seconds, sizeof(seconds));
+    close(result_pipe[0]);
+
+    int status{0};
+    rusage usage{};
+    if (wait4(child, &status, 0, &usage) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+        got != sizeof(seconds))
+    {
+        throw std::runtime_error("Child failed.");
+    }
+    return {seconds, usage.ru_maxrss};
+}
+
+template <typename Function>
+double BestSeconds(int runs, Function function)
+{
+    double best{1e9};
+    for (int i = 0; i < runs; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+size_t ReadWithDOM(const std::string &document)
+{
+    auto instance_xml = ParseXMLContent(EM::XBRLContent{EM::sv{document}});
+    auto filing_data = ExtractFilingData(instance_xml);
+    auto gaap_data = ExtractGAAPFields(instance_xml);
+    auto context_data = ExtractContextDefinitions(instance_xml);
+    return filing_data.period_end_date.size() + gaap_data.size() + context_data.size();
+}
+
+size_t ReadWithExpat(const std::string &document)
+{
+    auto instance_data = ExtractInstanceData(EM::XBRLContent{EM::sv{document}});
+    return instance_data.filing_data_.period_end_date.size() + instance_data.gaap_data_.size() +
+           instance_data.context_data_.size();
+}
+
+int BenchmarkFile(const fs::path &file_name, int runs)
+{
+    const auto document = ReadFile(file_name);
+    const double document_MB = static_cast<double>(document.size()) / (1024 * 1024);
+
+    // results go where the optimizer can't see they aren't used.
+
+    volatile size_t sink{0};
+
+    const auto baseline = RunInChild([&]() {
+        sink = static_cast<size_t>(std::ranges::count(document, '<'));
+        return 0.0;
+    });
+    const auto DOM = RunInChild([&]() { return BestSeconds(runs, [&]() { sink = ReadWithDOM(document); }); });
+    const auto expat = RunInChild([&]() { return BestSeconds(runs, [&]() { sink = ReadWithExpat(document); }); });
+
+    const EM::XBRLContent instance_document{EM::sv{document}};
+    const auto differences = CompareWithDOM(instance_document, ExtractInstanceData(instance_document));
+
+    auto report = [&](std::string_view name, const ChildResult &result) {
+        std::cout << std::format("  {:<6} {:8.1f} MB/s  max RSS: {:8.1f} MB ({:+.1f} MB)\n", name,
+                                 document_MB / result.seconds_, result.max_RSS_KB_ / 1024.0,
+                                 (result.max_RSS_KB_ - baseline.max_RSS_KB_) / 1024.0);
+    };
+
+    std::cout << std::format("{}: {:.1f} MB. starting max RSS: {:.1f} MB\n", file_name.string(), document_MB,
+                             baseline.max_RSS_KB_ / 1024.0);
+    report("DOM", DOM);
+    report("expat", expat);
+    if (differences.empty())
+    {
+        std::cout << "  results match\n";
+        return 0;
+    }
+    constexpr size_t k_max_shown{20};
+    for (const auto &difference : differences | std::views::take(k_max_shown))
+    {
+        std::cout << "  differs: " << difference << '\n';
+    }
+    if (differences.size() > k_max_shown)
+    {
+        std::cout << std::format("  ... {} differences in all\n", differences.size());
+    }
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, const char *argv[])
+{
+    int runs{5};
+    std::vector<std::string> files;
+
+    po::options_description options{"instance_bench options"};
+    options.add_options()("help,h", "produce help message")(
+        "runs", po::value<int>(&runs)->default_value(5), "passes over each file. the best one counts")(
+        "file", po::value<std::vector<std::string>>(&files), "instance documents to read");
+
+    po::positional_options_description positional;
+    positional.add("file", -1);
+
+    try
+    {
+        po::variables_map variable_map;
+        po::store(po::command_line_parser(argc, argv).options(options).positional(positional).run(), variable_map);
+        po::notify(variable_map);
+        if (variable_map.count("help") != 0 || files.empty())
+        {
+            std::cout << "instance_bench [options] instance_document...\n" << options << '\n';
+            return files.empty() ? 1 : 0;
+        }
+
+        spdlog::set_level(spdlog::level::warn);
+
+        int result{0};
+        for (const auto &file : files)
+        {
+            result |= BenchmarkFile(file, std::max(runs, 1));
+        }
+        return result;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Problem: " << e.what() << '\n';
+    }
+    return 1;
+}
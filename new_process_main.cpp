@@ -129,8 +129,8 @@ int main(int argc, const char *argv[])
 
         auto scan_file([&the_filters, &files_processed](const auto &input_file_name) {
             spdlog::info(catenate("Processing file: ", input_file_name));
-            const std::string file_content_text = LoadDataFileForUse(EM::FileName{input_file_name});
-            EM::FileContent file_content(file_content_text);
+            const MappedFile mapped_file{EM::FileName{input_file_name}};
+            EM::FileContent file_content(mapped_file.GetContent());
 
             try
             {
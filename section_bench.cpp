@@ -0,0 +1,315 @@
+// =====================================================================================
+//
+//       Filename:  section_bench.cpp
+//
+//    Description:  times LocateDocumentSections against the search based
+//                  version it replaced and checks both find the same sections.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 10:52:06 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+// each file is a full filing. the old way is kept here as it was before the
+// section scanner: std::search for <DOCUMENT>, boyer-moore for </DOCUMENT>
+// then a walk over the header lines of each section. speed is the best of
+// --runs passes. every field of every section must be the same piece of the
+// file in both tables.
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "Extractor.h"
+#include "Extractor_Utils.h"
+
+namespace po = boost::program_options;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+std::string ReadFile(const fs::path &file_name)
+{
+    std::ifstream file{file_name, std::ios::in | std::ios::binary};
+    if (!file)
+    {
+        throw std::runtime_error(catenate("Can't open: ", file_name.string()));
+    }
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+// collect the things we need to know about a document section.
+// the section header is a few '<TAG>value' lines ending with <TEXT>
+// so this is cheap to do.
+
+EM::DocumentSection DescribeDocumentSection(EM::sv document)
+{
+    static constexpr EM::sv type_tag{"<TYPE>"};
+    static constexpr EM::sv file_name_tag{"<FILENAME>"};
+    static constexpr EM::sv text_begin{"<TEXT>"};
+    static constexpr EM::sv text_end{"</TEXT>"};
+
+    EM::DocumentSection section{.content_ = document};
+
+    size_t line_begin{0};
+    while (line_begin < document.size())
+    {
+        auto line_end = document.find('\n', line_begin);
+        if (line_end == EM::sv::npos)
+        {
+            line_end = document.size();
+        }
+        auto line = document.substr(line_begin, line_end - line_begin);
+        line_begin = line_end + 1;
+
+        if (auto last = line.find_last_not_of(" \t\r"); last != EM::sv::npos)
+        {
+            line = line.substr(0, last + 1);
+        }
+
+        if (line.starts_with(type_tag) && section.type_.empty())
+        {
+            section.type_ = line.substr(type_tag.size());
+        }
+        else if (line.starts_with(file_name_tag) && section.file_name_.empty())
+        {
+            section.file_name_ = line.substr(file_name_tag.size());
+            if (auto dot = section.file_name_.rfind('.'); dot != EM::sv::npos)
+            {
+                section.extension_ = section.file_name_.substr(dot);
+            }
+        }
+        else if (line.starts_with(text_begin))
+        {
+            // text begins with the newline ending the <TEXT> line.
+
+            auto text = document.substr(line_end);
+            if (auto text_end_loc = text.rfind(text_end); text_end_loc != EM::sv::npos)
+            {
+                section.text_ = text.substr(0, text_end_loc);
+
+                // the first thing in the text tells us how it's packaged.
+
+                if (auto first = section.text_.find_first_not_of(" \t\r\n"); first != EM::sv::npos)
+                {
+                    auto leading = section.text_.substr(first);
+                    section.has_XBRL_ = leading.starts_with("<XBRL>");
+                    section.is_uuencoded_ = leading.starts_with("begin ");
+                }
+            }
+            break;
+        }
+    }
+    return section;
+}
+
+EM::DocumentSectionList SearchDocumentSections(EM::FileContent file_content)
+{
+    const std::string doc_begin{"<DOCUMENT>"};
+    const std::string doc_end{"</DOCUMENT>"};
+    const auto doc_begin_len = doc_begin.size();
+    const auto doc_end_len = doc_end.size();
+
+    EM::DocumentSectionList result;
+
+    auto found_begin = file_content.get().begin();
+    auto content_end = file_content.get().end();
+
+    auto doc_searcher = std::boyer_moore_searcher(doc_end.begin(), doc_end.end());
+
+    while (found_begin != content_end)
+    {
+        // look for our begin tag
+
+        found_begin = std::search(found_begin, content_end, doc_begin.begin(), doc_begin.end());
+
+        if (found_begin == content_end)
+        {
+            break;
+        }
+
+        // now, look for our end tag.
+        // since this can be rather far away, try boyer-moore
+
+        auto found_end = std::search(found_begin + doc_begin_len, content_end, doc_searcher);
+
+        if (found_end == content_end)
+        {
+            throw ExtractorException("Can't find end of 'DOCUMENT'");
+        }
+
+        result.emplace_back(DescribeDocumentSection(EM::sv(found_begin, found_end + doc_end_len - found_begin)));
+        found_begin = found_end + doc_end_len;
+    }
+    return result;
+}
+
+// 2 fields are the same if they are the same piece of the file. empty fields
+// match wherever they point.
+
+std::vector<std::string> CompareSections(EM::sv content, const EM::DocumentSectionList &search_sections,
+                                         const EM::DocumentSectionList &scanner_sections)
+{
+    std::vector<std::string> differences;
+    if (search_sections.size() != scanner_sections.size())
+    {
+        differences.push_back(
+            catenate("sections: search: ", search_sections.size(), " scanner: ", scanner_sections.size()));
+    }
+
+    auto describe = [content](EM::sv field) {
+        return field.empty() ? std::string{"(none)"}
+                             : catenate("offset ", field.data() - content.data(), " length ", field.size());
+    };
+    auto compare = [&](size_t i, std::string_view name, EM::sv search, EM::sv scanner) {
+        if ((search.data() != scanner.data() || search.size() != scanner.size()) &&
+            !(search.empty() && scanner.empty()))
+        {
+            differences.push_back(catenate("section: ", i, ' ', name, ": search: ", describe(search),
+                                           " scanner: ", describe(scanner)));
+        }
+    };
+
+    for (size_t i = 0; i < std::min(search_sections.size(), scanner_sections.size()); ++i)
+    {
+        const auto &search = search_sections[i];
+        const auto &scanner = scanner_sections[i];
+        compare(i, "content", search.content_, scanner.content_);
+        compare(i, "type", search.type_, scanner.type_);
+        compare(i, "file name", search.file_name_, scanner.file_name_);
+        compare(i, "extension", search.extension_, scanner.extension_);
+        compare(i, "text", search.text_, scanner.text_);
+        if (search.has_XBRL_ != scanner.has_XBRL_ || search.is_uuencoded_ != scanner.is_uuencoded_)
+        {
+            differences.push_back(catenate("section: ", i, " XBRL/uuencoded: search: ", search.has_XBRL_, '/',
+                                           search.is_uuencoded_, " scanner: ", scanner.has_XBRL_, '/',
+                                           scanner.is_uuencoded_));
+        }
+    }
+    return differences;
+}
+
+template <typename Function>
+double BestSeconds(int runs, Function function)
+{
+    double best{1e9};
+    for (int i = 0; i < runs; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int BenchmarkFile(const fs::path &file_name, int runs)
+{
+    const auto document = ReadFile(file_name);
+    const EM::FileContent file_content{EM::sv{document}};
+    const double document_MB = static_cast<double>(document.size()) / (1024 * 1024);
+
+    // results go where the optimizer can't see they aren't used.
+
+    volatile size_t sink{0};
+
+    const double search_seconds =
+        BestSeconds(runs, [&]() { sink = SearchDocumentSections(file_content).size(); });
+    const double scanner_seconds =
+        BestSeconds(runs, [&]() { sink = LocateDocumentSections(file_content).size(); });
+
+    const auto scanner_sections = LocateDocumentSections(file_content);
+    const auto differences =
+        CompareSections(file_content.get(), SearchDocumentSections(file_content), scanner_sections);
+
+    std::cout << std::format("{}: {:.1f} MB. {} sections\n", file_name.string(), document_MB,
+                             scanner_sections.size());
+    std::cout << std::format("  search:  {:8.1f} MB/s\n", document_MB / search_seconds);
+    std::cout << std::format("  scanner: {:8.1f} MB/s ({:.2f}x)\n", document_MB / scanner_seconds,
+                             search_seconds / scanner_seconds);
+    if (differences.empty())
+    {
+        std::cout << "  section tables match\n";
+        return 0;
+    }
+    constexpr size_t k_max_shown{20};
+    for (const auto &difference : differences | std::views::take(k_max_shown))
+    {
+        std::cout << "  differs: " << difference << '\n';
+    }
+    if (differences.size() > k_max_shown)
+    {
+        std::cout << std::format("  ... {} differences in all\n", differences.size());
+    }
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, const char *argv[])
+{
+    int runs{5};
+    std::vector<std::string> files;
+
+    po::options_description options{"section_bench options"};
+    options.add_options()("help,h", "produce help message")(
+        "runs", po::value<int>(&runs)->default_value(5), "passes over each file. the best one counts")(
+        "file", po::value<std::vector<std::string>>(&files), "filings to read");
+
+    po::positional_options_description positional;
+    positional.add("file", -1);
+
+    try
+    {
+        po::variables_map variable_map;
+        po::store(po::command_line_parser(argc, argv).options(options).positional(positional).run(), variable_map);
+        po::notify(variable_map);
+        if (variable_map.count("help") != 0 || files.empty())
+        {
+            std::cout << "section_bench [options] filing...\n" << options << '\n';
+            return files.empty() ? 1 : 0;
+        }
+
+        int result{0};
+        for (const auto &file : files)
+        {
+            result |= BenchmarkFile(file, std::max(runs, 1));
+        }
+        return result;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Problem: " << e.what() << '\n';
+    }
+    return 1;
+}
@@ -0,0 +1,151 @@
+// =====================================================================================
+//
+//       Filename:  BoundedQueue.h
+//
+//    Description:  Fixed capacity queue joining the stages of the concurrent
+//                  load pipeline.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 08:41:27 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef BOUNDEDQUEUE_H_
+#define BOUNDEDQUEUE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+
+// Fixed capacity queue for handing work from one pipeline stage to the next.
+// push blocks while the queue is full so a fast stage can't run away from a
+// slow one. once closed, pop returns nothing after the queue drains.
+
+template <typename T>
+class BoundedQueue
+{
+public:
+    struct Metrics
+    {
+        size_t capacity_;
+        size_t items_;
+        size_t max_depth_;
+        size_t full_waits_;
+        double average_depth_;
+    };
+
+    explicit BoundedQueue(size_t capacity) : capacity_{std::max<size_t>(capacity, 1)}
+    {
+    }
+
+    void push(T value)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (items_.size() >= capacity_)
+            {
+                ++full_waits_;
+                not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+            }
+            items_.push(std::move(value));
+
+            // depth as seen by each new arrival.
+
+            ++pushes_;
+            depth_total_ += items_.size();
+            max_depth_ = std::max(max_depth_, items_.size());
+        }
+        not_empty_.notify_one();
+    }
+
+    std::optional<T> pop()
+    {
+        std::optional<T> value;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+            if (items_.empty())
+            {
+                return value;
+            }
+            value.emplace(std::move(items_.front()));
+            items_.pop();
+        }
+        not_full_.notify_one();
+        return value;
+    }
+
+    // like pop but gives up after 'timeout'.
+
+    std::optional<T> pop_for(std::chrono::milliseconds timeout)
+    {
+        std::optional<T> value;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!not_empty_.wait_for(lock, timeout, [this] { return !items_.empty() || closed_; }) || items_.empty())
+            {
+                return value;
+            }
+            value.emplace(std::move(items_.front()));
+            items_.pop();
+        }
+        not_full_.notify_one();
+        return value;
+    }
+
+    // no more pushes. consumers drain what is left then get nothing.
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+    }
+
+    Metrics GetMetrics() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {capacity_, pushes_, max_depth_, full_waits_,
+                pushes_ == 0 ? 0.0 : static_cast<double>(depth_total_) / pushes_};
+    }
+
+private:
+    std::queue<T> items_;
+    size_t capacity_;
+    size_t pushes_{0};
+    size_t depth_total_{0};
+    size_t max_depth_{0};
+    size_t full_waits_{0};
+    bool closed_{false};
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+#endif /* BOUNDEDQUEUE_H_ */
@@ -16,6 +16,10 @@
  */
 
 #include "ConnectionQueue.h"
+
+#include <algorithm>
+#include <format>
+
 #include <spdlog/spdlog.h>
 
 PooledConnection::PooledConnection(std::unique_ptr<pqxx::connection> conn, ConnectionQueue &pool)
@@ -33,29 +37,91 @@ PooledConnection::~PooledConnection()
     }
 }
 
-ConnectionQueue::ConnectionQueue(const std::string &connection_string, size_t max_size)
-    : connection_string_(connection_string), max_size_(max_size)
+ConnectionQueue::ConnectionQueue(const std::string &connection_string, size_t max_size, OnConnect on_connect,
+                                 std::optional<AdaptiveSizing> adaptive)
+    : connection_string_(connection_string),
+      initial_size_(max_size),
+      size_(max_size),
+      on_connect_(std::move(on_connect)),
+      adaptive_(std::move(adaptive))
 {
-    for (size_t i = 0; i < max_size_; ++i)
+    for (size_t i = 0; i < size_; ++i)
+    {
+        available_.push_back({make_connection(), std::chrono::steady_clock::now()});
+    }
+    stats_.opened_ = size_;
+
+    if (adaptive_)
+    {
+        spdlog::info("Connection queue initialized with {} connections. May grow to {}.", size_,
+                     adaptive_->max_size_);
+    }
+    else
     {
-        available_.push({std::make_unique<pqxx::connection>(connection_string_), std::chrono::steady_clock::now()});
+        spdlog::info("Connection queue initialized with {} connections.", size_);
     }
-    spdlog::info("Connection queue initialized with {} connections.", max_size_);
 }
 
 PooledConnection ConnectionQueue::get_connection()
 {
+    using namespace std::chrono;
+
+    const auto started = steady_clock::now();
+    auto have_connection = [this] { return !available_.empty(); };
+
     ConnectionEntry entry;
+    bool grow{false};
+    std::vector<ConnectionEntry> idle;
     {
         std::unique_lock<std::mutex> lock(mutex_);
-        condition_.wait(lock, [this] { return !available_.empty(); });
+        idle = take_idle_connections();
+
+        if (adaptive_ && !condition_.wait_for(lock, adaptive_->grow_after_, have_connection) &&
+            size_ < adaptive_->max_size_)
+        {
+            // take the slot now so other waiters don't all grow at once.
+
+            ++size_;
+            grow = true;
+        }
+        else
+        {
+            condition_.wait(lock, have_connection);
+            entry = std::move(available_.back());
+            available_.pop_back();
+        }
 
-        entry = std::move(available_.front());
-        available_.pop();
+        const auto waited = duration_cast<microseconds>(steady_clock::now() - started);
+        ++stats_.acquisitions_;
+        stats_.total_wait_ += waited;
+        stats_.max_wait_ = std::max(stats_.max_wait_, waited);
+        auto bucket = std::ranges::find_if(k_wait_bucket_limits, [waited](auto limit) { return waited < limit; });
+        ++stats_.wait_histogram_[bucket - k_wait_bucket_limits.begin()];
     }
+    idle.clear();
 
-    auto now = std::chrono::steady_clock::now();
-    bool needs_health_check = (now - entry.last_used) > std::chrono::seconds(30);
+    if (grow)
+    {
+        try
+        {
+            entry.conn = make_connection();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --size_;
+            throw;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.opened_;
+        ++stats_.grown_;
+        spdlog::debug("Connection queue grew to {} connections.", size_);
+        return PooledConnection(std::move(entry.conn), *this);
+    }
+
+    auto now = steady_clock::now();
+    bool needs_health_check = (now - entry.last_used) > seconds(30);
 
     if (!entry.conn || !entry.conn->is_open() || needs_health_check)
     {
@@ -69,8 +135,33 @@ PooledConnection ConnectionQueue::get_connection()
 
             if (needs_health_check)
             {
-                pqxx::nontransaction test_trxn{*entry.conn};
-                test_trxn.exec("SELECT 1");
+                const auto check_started = steady_clock::now();
+                std::optional<std::string> failure;
+                try
+                {
+                    pqxx::nontransaction test_trxn{*entry.conn};
+                    test_trxn.exec("SELECT 1");
+                }
+                catch (const std::exception &e)
+                {
+                    failure = e.what();
+                }
+
+                const auto check_time = duration_cast<microseconds>(steady_clock::now() - check_started);
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    ++stats_.health_checks_;
+                    stats_.total_health_check_ += check_time;
+                    stats_.max_health_check_ = std::max(stats_.max_health_check_, check_time);
+                    if (failure)
+                    {
+                        ++stats_.failed_health_checks_;
+                    }
+                }
+                if (failure)
+                {
+                    throw std::runtime_error(*failure);
+                }
                 spdlog::trace("Connection health check passed");
             }
         }
@@ -79,26 +170,64 @@ PooledConnection ConnectionQueue::get_connection()
             spdlog::warn("Connection stale or broken: {}. Renewing.", e.what());
             try
             {
-                entry.conn = std::make_unique<pqxx::connection>(connection_string_);
+                entry.conn = make_connection();
             }
             catch (...)
             {
                 return_connection(std::move(entry.conn));
                 throw;
             }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.opened_;
+            ++stats_.renewed_;
         }
     }
 
     return PooledConnection(std::move(entry.conn), *this);
 }
 
+std::unique_ptr<pqxx::connection> ConnectionQueue::make_connection() const
+{
+    auto conn = std::make_unique<pqxx::connection>(connection_string_);
+    if (on_connect_)
+    {
+        on_connect_(*conn);
+    }
+    return conn;
+}
+
+std::vector<ConnectionEntry> ConnectionQueue::take_idle_connections()
+{
+    std::vector<ConnectionEntry> idle;
+    if (!adaptive_)
+    {
+        return idle;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    while (size_ > initial_size_ && !available_.empty() &&
+           now - available_.front().last_used > adaptive_->idle_timeout_)
+    {
+        idle.push_back(std::move(available_.front()));
+        available_.pop_front();
+        --size_;
+        ++stats_.closed_idle_;
+    }
+    return idle;
+}
+
 void ConnectionQueue::return_connection(std::unique_ptr<pqxx::connection> conn)
 {
     // Removed the `if (!conn) return;` check.
     // We MUST allow null connections back into the queue to maintain the pool's max size.
-    std::lock_guard<std::mutex> lock(mutex_);
-    available_.push({std::move(conn), std::chrono::steady_clock::now()});
-    condition_.notify_one();
+    std::vector<ConnectionEntry> idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        available_.push_back({std::move(conn), std::chrono::steady_clock::now()});
+        idle = take_idle_connections();
+        condition_.notify_one();
+    }
 }
 
 size_t ConnectionQueue::available_count() const
@@ -107,6 +236,55 @@ size_t ConnectionQueue::available_count() const
     return available_.size();
 }
 
+size_t ConnectionQueue::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+ConnectionQueue::Stats ConnectionQueue::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.size_ = size_;
+    stats.available_ = available_.size();
+    stats.max_size_ = adaptive_ ? adaptive_->max_size_ : initial_size_;
+    return stats;
+}
+
+void ConnectionQueue::log_stats() const
+{
+    const auto stats = this->stats();
+
+    auto average = [](std::chrono::microseconds total, uint64_t count) {
+        return count == 0 ? 0 : total.count() / static_cast<int64_t>(count);
+    };
+
+    std::string histogram;
+    for (size_t i = 0; i < stats.wait_histogram_.size(); ++i)
+    {
+        if (i < k_wait_bucket_limits.size())
+        {
+            histogram += std::format("<{}us: {}. ", k_wait_bucket_limits[i].count(), stats.wait_histogram_[i]);
+        }
+        else
+        {
+            histogram += std::format("longer: {}.", stats.wait_histogram_[i]);
+        }
+    }
+
+    spdlog::info("Connection queue. Size: {} of {}. Available: {}. Acquisitions: {}. Average wait: {}us. "
+                 "Max wait: {}us.",
+                 stats.size_, stats.max_size_, stats.available_, stats.acquisitions_,
+                 average(stats.total_wait_, stats.acquisitions_), stats.max_wait_.count());
+    spdlog::info("Connection queue waits. {}", histogram);
+    spdlog::info("Connection queue health checks: {}. Failed: {}. Average: {}us. Max: {}us.", stats.health_checks_,
+                 stats.failed_health_checks_, average(stats.total_health_check_, stats.health_checks_),
+                 stats.max_health_check_.count());
+    spdlog::info("Connection queue churn. Opened: {}. Renewed: {}. Grown: {}. Closed idle: {}.", stats.opened_,
+                 stats.renewed_, stats.grown_, stats.closed_idle_);
+}
+
 bool ConnectionQueue::test_connection() const
 {
     try
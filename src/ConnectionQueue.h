@@ -18,13 +18,18 @@
 #ifndef CONNECTIONQUEUE_H_
 #define CONNECTIONQUEUE_H_
 
+#include <array>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <pqxx/pqxx>
-#include <queue>
 #include <string>
+#include <vector>
 
 struct ConnectionEntry
 {
@@ -37,18 +42,84 @@ class PooledConnection;
 class ConnectionQueue
 {
 public:
-    explicit ConnectionQueue(const std::string &connection_string, size_t max_size = 4);
+    // on_connect runs on every new connection, including renewals. Use it
+    // for per-session setup such as preparing statements.
+
+    using OnConnect = std::function<void(pqxx::connection &)>;
+
+    // Adaptive sizing. The queue starts with its initial size. When a caller
+    // has waited grow_after for a connection, another one is opened, up to
+    // max_size. Connections idle longer than idle_timeout are closed until
+    // the queue is back to its initial size.
+
+    struct AdaptiveSizing
+    {
+        size_t max_size_;
+        std::chrono::milliseconds grow_after_{5};
+        std::chrono::seconds idle_timeout_{60};
+    };
+
+    // Acquire waits are counted in buckets with these upper bounds. The last
+    // bucket holds everything longer.
+
+    static constexpr std::array<std::chrono::microseconds, 6> k_wait_bucket_limits{
+        std::chrono::microseconds{100}, std::chrono::milliseconds{1}, std::chrono::milliseconds{10},
+        std::chrono::milliseconds{100}, std::chrono::seconds{1},      std::chrono::seconds{10}};
+
+    struct Stats
+    {
+        size_t size_{0};
+        size_t available_{0};
+        size_t max_size_{0};
+
+        uint64_t acquisitions_{0};
+        std::array<uint64_t, k_wait_bucket_limits.size() + 1> wait_histogram_{};
+        std::chrono::microseconds total_wait_{0};
+        std::chrono::microseconds max_wait_{0};
+
+        uint64_t health_checks_{0};
+        uint64_t failed_health_checks_{0};
+        std::chrono::microseconds total_health_check_{0};
+        std::chrono::microseconds max_health_check_{0};
+
+        uint64_t opened_{0};      // every new connection, including the ones below
+        uint64_t renewed_{0};     // replaced a closed or broken connection
+        uint64_t grown_{0};       // added by adaptive sizing
+        uint64_t closed_idle_{0}; // removed by adaptive sizing
+    };
+
+    explicit ConnectionQueue(const std::string &connection_string, size_t max_size = 4, OnConnect on_connect = {},
+                             std::optional<AdaptiveSizing> adaptive = std::nullopt);
     PooledConnection get_connection();
     void return_connection(std::unique_ptr<pqxx::connection> conn);
     size_t available_count() const;
+    size_t size() const;
     bool test_connection() const;
 
+    Stats stats() const;
+    void log_stats() const;
+
 private:
+    std::unique_ptr<pqxx::connection> make_connection() const;
+
+    // Caller holds the lock. The connections are handed back so they can be
+    // closed after it is released.
+
+    std::vector<ConnectionEntry> take_idle_connections();
+
     std::string connection_string_;
-    size_t max_size_;
+    size_t initial_size_;
+    size_t size_;
+    OnConnect on_connect_;
+    std::optional<AdaptiveSizing> adaptive_;
     mutable std::mutex mutex_;
     std::condition_variable condition_;
-    std::queue<ConnectionEntry> available_;
+
+    // Most recently returned at the back. Connections are handed out from the
+    // back so any extras collect, idle, at the front.
+
+    std::deque<ConnectionEntry> available_;
+    Stats stats_;
 };
 
 class PooledConnection
@@ -0,0 +1,90 @@
+// =====================================================================================
+//
+//       Filename:  CopyTextWriter.cpp
+//
+//    Description:  Writes rows to a table with COPY, formatting the text
+//                  ourselves.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 02:41:08 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "CopyTextWriter.h"
+
+void AppendCopyText(std::string &buffer, std::string_view field)
+{
+    // COPY text format only cares about these. most of our fields have none.
+
+    static constexpr std::string_view k_specials{"\\\t\n\r"};
+
+    auto next = field.find_first_of(k_specials);
+    while (next != std::string_view::npos)
+    {
+        buffer.append(field.substr(0, next));
+        buffer += '\\';
+        switch (field[next])
+        {
+        case '\t':
+            buffer += 't';
+            break;
+        case '\n':
+            buffer += 'n';
+            break;
+        case '\r':
+            buffer += 'r';
+            break;
+        default:
+            buffer += '\\';
+            break;
+        }
+        field.remove_prefix(next + 1);
+        next = field.find_first_of(k_specials);
+    }
+    buffer.append(field);
+} /* -----  end of function AppendCopyText  ----- */
+
+CopyTextWriter::CopyTextWriter(pqxx::transaction_base &trxn, pqxx::table_path table,
+                               std::initializer_list<std::string_view> columns)
+    : stream_{pqxx::stream_to::table(trxn, table, columns)}
+{
+    buffer_.reserve(k_flush_size + 4096);
+} // -----  end of method CopyTextWriter::CopyTextWriter  (constructor)  -----
+
+void CopyTextWriter::Flush()
+{
+    // rows are separated by newlines. write_raw_line adds the last one.
+
+    if (buffered_rows_ > 0)
+    {
+        stream_.write_raw_line(buffer_);
+        buffer_.clear();
+        buffered_rows_ = 0;
+    }
+} // -----  end of method CopyTextWriter::Flush  -----
+
+void CopyTextWriter::Complete()
+{
+    Flush();
+    stream_.complete();
+} // -----  end of method CopyTextWriter::Complete  -----
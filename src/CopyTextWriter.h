@@ -0,0 +1,154 @@
+// =====================================================================================
+//
+//       Filename:  CopyTextWriter.h
+//
+//    Description:  Writes rows to a table with COPY, formatting the text
+//                  ourselves.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 02:41:08 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+// =====================================================================================
+//        Class:  CopyTextWriter
+//  Description:  pqxx::stream_to converts and escapes each field on its own and
+//                hands libpq 1 row at a time. All our fields are already text
+//                so we escape them straight into a buffer and pass along many
+//                rows at once with write_raw_line.
+//
+//                Use it like stream_to: WriteRow for each row then Complete.
+// =====================================================================================
+
+#ifndef COPYTEXTWRITER_H_
+#define COPYTEXTWRITER_H_
+
+#include <format>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <pqxx/pqxx>
+
+// COPY text format. a row is its fields separated by tabs. the caller adds the newline.
+
+void AppendCopyText(std::string &buffer, std::string_view field);
+
+template <typename Field> void AppendCopyField(std::string &buffer, const Field &field)
+{
+    if constexpr (std::is_same_v<Field, bool>)
+    {
+        buffer += field ? 't' : 'f';
+    }
+    else if constexpr (std::is_integral_v<Field>)
+    {
+        std::format_to(std::back_inserter(buffer), "{}", field);
+    }
+    else if constexpr (std::is_same_v<Field, std::nullopt_t>)
+    {
+        buffer += "\\N";
+    }
+    else if constexpr (std::is_same_v<Field, std::optional<std::string>>)
+    {
+        if (field)
+        {
+            AppendCopyText(buffer, *field);
+        }
+        else
+        {
+            buffer += "\\N";
+        }
+    }
+    else
+    {
+        AppendCopyText(buffer, std::string_view{field});
+    }
+}
+
+template <typename... Fields> void AppendCopyRow(std::string &buffer, const Fields &...fields)
+{
+    bool first{true};
+    auto append = [&buffer, &first](const auto &field) {
+        if (!first)
+        {
+            buffer += '\t';
+        }
+        first = false;
+        AppendCopyField(buffer, field);
+    };
+    (append(fields), ...);
+}
+
+class CopyTextWriter
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    CopyTextWriter(pqxx::transaction_base &trxn, pqxx::table_path table,
+                   std::initializer_list<std::string_view> columns);
+    CopyTextWriter(const CopyTextWriter &rhs) = delete;
+    CopyTextWriter(CopyTextWriter &&rhs) = delete;
+
+    ~CopyTextWriter() = default;
+
+    // ====================  MUTATORS      =======================================
+
+    template <typename... Fields> void WriteRow(const Fields &...fields)
+    {
+        if (buffered_rows_ > 0)
+        {
+            buffer_ += '\n';
+        }
+        AppendCopyRow(buffer_, fields...);
+        ++buffered_rows_;
+
+        if (buffer_.size() >= k_flush_size)
+        {
+            Flush();
+        }
+    }
+
+    void Complete();
+
+    // ====================  OPERATORS     =======================================
+
+    CopyTextWriter &operator=(const CopyTextWriter &rhs) = delete;
+    CopyTextWriter &operator=(CopyTextWriter &&rhs) = delete;
+
+private:
+    static constexpr size_t k_flush_size{64 * 1024};
+
+    void Flush();
+
+    // ====================  DATA MEMBERS  =======================================
+
+    pqxx::stream_to stream_;
+    std::string buffer_;
+    size_t buffered_rows_{0};
+
+}; // -----  end of class CopyTextWriter  -----
+
+#endif /* COPYTEXTWRITER_H_ */
@@ -18,8 +18,12 @@
 #include "DatabasePool.h"
 #include <spdlog/spdlog.h>
 
-DatabasePool::DatabasePool(const std::string &connection_string, size_t pool_size)
-    : connection_string_{connection_string}, pool_size_{pool_size}, connection_queue_{connection_string, pool_size}
+DatabasePool::DatabasePool(const std::string &connection_string, size_t pool_size,
+                           ConnectionQueue::OnConnect on_connect,
+                           std::optional<ConnectionQueue::AdaptiveSizing> adaptive)
+    : connection_string_{connection_string},
+      pool_size_{pool_size},
+      connection_queue_{connection_string, pool_size, std::move(on_connect), std::move(adaptive)}
 {
 
     if (!test_connection())
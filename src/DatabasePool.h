@@ -24,7 +24,12 @@
 class DatabasePool
 {
 public:
-    DatabasePool(const std::string &connection_string, size_t pool_size = 4);
+    // with adaptive sizing, pool_size is where the pool starts and the
+    // least it shrinks back to.
+
+    DatabasePool(const std::string &connection_string, size_t pool_size = 4,
+                 ConnectionQueue::OnConnect on_connect = {},
+                 std::optional<ConnectionQueue::AdaptiveSizing> adaptive = std::nullopt);
 
     // Get a connection wrapper (blocking if all in use)
     PooledConnection get_connection();
@@ -32,10 +37,19 @@ public:
     bool test_connection() const;
     size_t pool_size() const
     {
-        return pool_size_;
+        return connection_queue_.size();
     }
     size_t available_count() const;
 
+    ConnectionQueue::Stats stats() const
+    {
+        return connection_queue_.stats();
+    }
+    void log_stats() const
+    {
+        connection_queue_.log_stats();
+    }
+
 private:
     std::string connection_string_;
     size_t pool_size_;
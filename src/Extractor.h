@@ -211,7 +211,6 @@ using XLS_Values = std::vector<XLS_Entry>;
 // lets' add a little type safety based on ideas from fluentcpp
 
 using FileContent = UniqType<sv, struct FileContentTag>;
-using DocumentSection = UniqType<sv, struct DocumentSectionTag>;
 using XBRLContent = UniqType<sv, struct XBRLContentTag>;
 using XLSContent = UniqType<sv, struct XLSContentTag>;
 using HTMLContent = UniqType<sv, struct HTMLContentTag>;
@@ -220,6 +219,21 @@ using FileType = UniqType<sv, struct FileTypeTag>;
 using AnchorContent = UniqType<sv, struct AnchorContentTag>;
 using TableContent = UniqType<sv, struct TableContentTag>;
 
+// each <DOCUMENT> in a filing along with what we need to know about it.
+// all of this is collected when we first locate the section so we don't need
+// to re-scan the section each time we want to know what kind of document it is.
+
+struct DocumentSection
+{
+    sv content_;             // <DOCUMENT> through </DOCUMENT>
+    sv type_;                // value of <TYPE> line
+    sv file_name_;           // value of <FILENAME> line
+    sv extension_;           // file name extension including the '.'
+    sv text_;                // from end of <TEXT> line up to </TEXT>. empty if no </TEXT>
+    bool has_XBRL_ = false;  // text is wrapped in <XBRL> tags
+    bool is_uuencoded_ = false; // text is a uuencoded file (spreadsheets, images, etc.)
+};
+
 using DocumentSectionList = std::vector<DocumentSection>;
 
 } // namespace Extractor
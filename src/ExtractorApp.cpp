@@ -42,7 +42,6 @@
 #include <csignal>
 #include <exception>
 #include <fstream>
-#include <future>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -54,9 +53,11 @@
 
 #include <ranges>
 
+#include "BoundedQueue.h"
 #include "Extractor.h"
 #include "Extractor_HTML_FileFilter.h"
 #include "Extractor_XBRL_FileFilter.h"
+#include "GroupCommitWriter.h"
 #include "SEC_Header.h"
 
 #include "spdlog/sinks/basic_file_sink.h"
@@ -88,48 +89,6 @@ namespace rng = std::ranges;
 
 bool ExtractorApp::had_signal_ = false;
 
-// code from "The C++ Programming Language" 4th Edition. p. 1243.
-// with modifications.
-//
-// return index of ready future
-// if no future is ready, wait for d before trying again
-
-template <typename T>
-int wait_for_any(std::vector<std::future<T>> &vf, int continue_here, std::chrono::steady_clock::duration d)
-{
-    while (true)
-    {
-        for (int i = continue_here; i != vf.size(); ++i)
-        {
-            if (!vf[i].valid())
-            {
-                continue;
-            }
-            switch (vf[i].wait_for(std::chrono::seconds{0}))
-            {
-                case std::future_status::ready:
-                    return i;
-
-                case std::future_status::timeout:
-                    break;
-
-                case std::future_status::deferred:
-                    throw std::runtime_error("wait_for_all(): deferred future");
-            }
-        }
-        continue_here = 0;
-
-        if (ExtractorApp::SignalReceived())
-        {
-            break;
-        }
-
-        std::this_thread::sleep_for(d);
-    }
-
-    return -1;
-}
-
 /*
  *--------------------------------------------------------------------------------------
  *       Class:  ExtractorApp
@@ -334,6 +293,9 @@ void ExtractorApp::SetupProgramOptions(void)
             }
             return std::string{}; // Return an empty string for success
         });
+    input_source_group->add_option("--load-shards", load_shards_directory_,
+                                   "directory of shard sets written by --output-shards to load into the DB.")
+        ->check(CLI::ExistingDirectory);
 
     // specify the min and max number of options from the group to be allowed.
     input_source_group->require_option(1, 1);
@@ -342,9 +304,22 @@ void ExtractorApp::SetupProgramOptions(void)
                     "directory to write exported HTML data files to.");
     app_.add_option("--HTML-forms-from-dir", HTML_export_source_directory_,
                     "directory to read exported HTML data files from.");
+    app_.add_option("--output-shards", output_shards_directory_,
+                    "write extracted data to COPY-ready shard files in this directory instead of the DB.");
+    app_.add_option("--shard-MB", shard_MB_, "Shard mode: start a new shard set once one reaches this many MB.")
+        ->default_val(256)
+        ->check(CLI::PositiveNumber);
+    app_.add_option("--export-facts", export_facts_directory_,
+                    "write extracted values to Parquet files partitioned by form type and period instead of the DB.");
 
     app_.add_flag("-R,--replace-DB-content", replace_DB_content_,
                   "replace all DB content for each file. Default is 'false'");
+    app_.add_flag("--upsert-filing-id", upsert_filing_ID_,
+                  "add or update each filing's sec_filing_id row with a single INSERT ... ON CONFLICT statement. "
+                  "Default is 'false'");
+    app_.add_flag("--verify-instance-reader", verify_instance_reader_,
+                  "also extract each XBRL instance document with the DOM parser and treat any difference from the "
+                  "streaming reader as an error. slow. Default is 'false'");
     app_.add_flag("--export-XLS-data", export_XLS_files_, "export Excel data if any. Default is 'false'");
     app_.add_flag("--export-HTML-data", export_HTML_forms_, "export problem HTML data if any. Default is 'false'");
     app_.add_flag("--UpdateSharesOutstanding", update_shares_outstanding_, "Update Shares outstanding value in DB.");
@@ -361,6 +336,8 @@ void ExtractorApp::SetupProgramOptions(void)
     app_.add_option("--DB-mode", DB_mode_, "Must be either 'test' or 'live'.")
         ->default_val("test")
         ->check(CLI::IsMember({"test", "live"}));
+    app_.add_option("--DB-connection", DB_connection_, "libpq connection string for extract database.")
+        ->default_val("dbname=sec_extracts user=extractor_pg");
 
     // Note: The original help text mentions a comma-delimited list, but the code
     // binds to a single string. This conversion maintains that behavior. CLI11
@@ -384,6 +361,24 @@ void ExtractorApp::SetupProgramOptions(void)
     app_.add_option("--max-files", max_forms_to_process_, "Maximun number of forms to process -- mainly for testing.")
         ->default_val(-1);
     app_.add_option("-k,--concurrent", max_at_a_time_, "Maximun number of concurrent processes.")->default_val(-1);
+    app_.add_option("--read-threads", read_threads_, "Concurrent mode: number of threads reading files.")
+        ->default_val(2);
+    app_.add_option("--extract-threads", extract_threads_,
+                    "Concurrent mode: number of threads extracting content. Default is 1 per core.")
+        ->default_val(0);
+    app_.add_option("--batch-rows", batch_rows_,
+                    "Concurrent mode: commit stored filings once they add this many rows. 0 commits each filing.")
+        ->default_val(20000);
+    app_.add_option("--batch-ms", batch_ms_,
+                    "Concurrent mode: longest a stored filing waits for its batch to commit, in milliseconds.")
+        ->default_val(1000);
+    app_.add_flag("--bulk-load", bulk_load_,
+                  "for initial loads. drop the text search indexes on the data tables while loading and rebuild "
+                  "them at the end. a run which stops early leaves them for the next bulk load. Default is 'false'");
+    app_.add_option("--index-build-workers", index_build_workers_,
+                    "Bulk mode: parallel maintenance workers to use for each index rebuild.")
+        ->default_val(4)
+        ->check(CLI::NonNegativeNumber);
 
     app_.add_flag("--filename-has-form", filename_has_form_, "form number is in file path. Default is 'false'");
     app_.add_option("--resume-at", resume_at_this_filename_,
@@ -485,13 +480,76 @@ bool ExtractorApp::CheckArgs()
         BuildListOfFilesToProcess();
     }
 
-    BuildFilterList();
-
     // make sure we don't have too many threads allocated.
     // this can happen mainly in testing but also, in general, with a short file
-    // list
+    // list. we can't know how many files a directory holds until we walk it so
+    // leave the limit alone in that case.
 
-    max_at_a_time_ = std::min<int>(max_at_a_time_, list_of_files_to_process_.size());
+    if (local_form_file_directory_.get().empty() && load_shards_directory_.get().empty())
+    {
+        max_at_a_time_ = std::min<int>(max_at_a_time_, list_of_files_to_process_.size());
+    }
+
+    // writing shards is for boxes which can't reach the DB. they get loaded
+    // later with --load-shards.
+
+    const bool writing_shards = !output_shards_directory_.get().empty();
+    if (writing_shards)
+    {
+        BOOST_ASSERT_MSG(!export_HTML_forms_ && !update_shares_outstanding_,
+                         "Can't write shards when exporting HTML or updating shares outstanding.");
+        fs::create_directories(output_shards_directory_.get());
+        shard_writer_ = std::make_unique<ShardWriter>(output_shards_directory_.get(), 0,
+                                                      static_cast<size_t>(shard_MB_) * 1024 * 1024);
+    }
+
+    // exporting facts is for analysis outside the DB so, like shards, nothing
+    // is checked against the DB.
+
+    const bool exporting_facts = !export_facts_directory_.get().empty();
+    if (exporting_facts)
+    {
+        BOOST_ASSERT_MSG(!export_HTML_forms_ && !update_shares_outstanding_ && !writing_shards,
+                         "Can't export facts when exporting HTML, updating shares outstanding or writing shards.");
+        fs::create_directories(export_facts_directory_.get());
+        fact_exporter_ = std::make_unique<FactExporter>(export_facts_directory_.get(), 0);
+    }
+
+    // exporting HTML, writing shards and exporting facts are the only modes which never touch the DB.
+
+    // when running concurrently, the readers also use the DB to check for
+    // existing content.
+
+    if (!export_HTML_forms_ && !writing_shards && !exporting_facts)
+    {
+        // the store workers each hold a connection for the length of a batch. the readers
+        // only need one now and then (and not at all for pre-checked files) so the pool
+        // starts with 1 per store worker and grows toward 1 per reader as well if they
+        // start waiting.
+
+        const int store_connections = std::max(1, max_at_a_time_);
+        const int max_connections = max_at_a_time_ < 1 ? 1 : max_at_a_time_ + std::max(1, read_threads_);
+        db_pool_ = std::make_unique<DatabasePool>(
+            DB_connection_, store_connections,
+            [schema_name = schema_prefix_ + "unified_extracts"](pqxx::connection &conn)
+            { PrepareFilingIDStatements(conn, schema_name); },
+            ConnectionQueue::AdaptiveSizing{.max_size_ = static_cast<size_t>(max_connections)});
+    }
+
+    if (bulk_load_)
+    {
+        BOOST_ASSERT_MSG(db_pool_ && !update_shares_outstanding_, "Bulk load needs a mode which loads the DB.");
+    }
+
+    // with -R every file gets loaded so there's nothing to check.
+
+    if (!list_of_files_to_process_.empty() && !export_HTML_forms_ && !update_shares_outstanding_ &&
+        !replace_DB_content_ && !writing_shards && !exporting_facts)
+    {
+        PrecheckListOfFiles();
+    }
+
+    BuildFilterList();
 
     if (export_XLS_files_)
     {
@@ -540,6 +598,86 @@ void ExtractorApp::BuildListOfFilesToProcess()
     spdlog::info(catenate("Resuming with: ", list_of_files_to_process_.size(), " files in list."));
 } /* -----  end of method ExtractorApp::BuildListOfFilesToProcess  ----- */
 
+void ExtractorApp::PrecheckListOfFiles()
+{
+    // read the SEC header of every file in our list, a slice per thread, and ask
+    // the DB about all of them at once.
+    // files we can't read are left for the load to complain about.
+
+    const size_t thread_count = std::min<size_t>(
+        std::max(1U, std::thread::hardware_concurrency()), list_of_files_to_process_.size());
+
+    std::vector<std::vector<FilingKeyFields>> keys_by_thread(thread_count);
+    {
+        std::vector<std::jthread> readers;
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            readers.emplace_back(
+                [this, i, thread_count, &keys = keys_by_thread[i]]()
+                {
+                    for (size_t next = i; next < list_of_files_to_process_.size(); next += thread_count)
+                    {
+                        try
+                        {
+                            const std::string header_content =
+                                LoadSECHeaderForUse(EM::FileName{list_of_files_to_process_[next]});
+
+                            SEC_Header SEC_data;
+                            SEC_data.UseData(EM::FileContent{header_content});
+                            SEC_data.ExtractHeaderFields();
+                            const auto &fields = SEC_data.GetFields();
+
+                            EM::sv base_form_type{fields.at("form_type")};
+                            if (base_form_type.ends_with("_A"))
+                            {
+                                base_form_type.remove_suffix(2);
+                            }
+                            keys.emplace_back(fields.at("cik"), base_form_type, fields.at("quarter_ending"));
+                        }
+                        catch (const std::exception &e)
+                        {
+                            spdlog::debug(catenate("Precheck skipping file: ", list_of_files_to_process_[next], ". ",
+                                                   e.what()));
+                        }
+                    }
+                });
+        }
+    }
+
+    // a key which shows up more than once, say an original form and its amendment,
+    // has to be checked as each file comes along since an earlier file may have
+    // stored it by then.
+
+    std::unordered_map<std::string, int> key_counts;
+    for (const auto &keys : keys_by_thread)
+    {
+        for (const auto &[cik, form_type, period_ending] : keys)
+        {
+            ++key_counts[FilingKey(cik, form_type, period_ending)];
+        }
+    }
+
+    std::vector<FilingKeyFields> candidates;
+    candidates.reserve(key_counts.size());
+    for (auto &keys : keys_by_thread)
+    {
+        for (auto &key : keys)
+        {
+            const auto &[cik, form_type, period_ending] = key;
+            if (key_counts[FilingKey(cik, form_type, period_ending)] == 1)
+            {
+                candidates.push_back(std::move(key));
+            }
+        }
+    }
+
+    prechecked_filings_ = FindExistingFilings(db_pool_.get(), schema_prefix_, data_source_, candidates);
+
+    spdlog::info(catenate("Prechecked: ", candidates.size(), " files against DB. Already loaded: ",
+                          rng::count_if(*prechecked_filings_, [](const auto &e) { return e.second.has_value(); }),
+                          ". Left for per-file check: ", list_of_files_to_process_.size() - candidates.size(), "."));
+} /* -----  end of method ExtractorApp::PrecheckListOfFiles  ----- */
+
 void ExtractorApp::BuildFilterList()
 {
     //  // XBRL and HTML filters will be applied manually, later
@@ -551,9 +689,12 @@ void ExtractorApp::BuildFilterList()
         filters_.emplace_back(FileIsWithinDateRange{begin_date_, end_date_});
     }
 
-    if ((!export_HTML_forms_ && !update_shares_outstanding_))
+    // shards are checked against the DB when they are loaded.
+
+    if (!export_HTML_forms_ && !update_shares_outstanding_ && !shard_writer_ && !fact_exporter_)
     {
-        filters_.emplace_back(NeedToUpdateDBContent{schema_prefix_, data_source_, replace_DB_content_});
+        filters_.emplace_back(NeedToUpdateDBContent{db_pool_.get(), schema_prefix_, data_source_, replace_DB_content_,
+                                                    prechecked_filings_ ? &prechecked_filings_.value() : nullptr});
     }
 
     if (!form_list_.empty())
@@ -574,6 +715,13 @@ void ExtractorApp::BuildFilterList()
 
 std::tuple<int, int, int> ExtractorApp::Run()
 {
+    if (bulk_load_)
+    {
+        auto conn = db_pool_->get_connection();
+        auto deferred = DeferDataTableIndexes(*conn, schema_prefix_ + "unified_extracts");
+        spdlog::info(catenate("Bulk load. Indexes to rebuild when done: ", deferred, "."));
+    }
+
     std::tuple<int, int, int> single_counters{0, 0, 0};
 
     // for now, I know this is all we are doing.
@@ -601,41 +749,94 @@ std::tuple<int, int, int> ExtractorApp::Run()
 
     if (!local_form_file_directory_.get().empty())
     {
-        local_counters = this->ProcessDirectory();
+        if (max_at_a_time_ < 1)
+        {
+            local_counters = this->ProcessDirectory();
+        }
+        else
+        {
+            local_counters = this->ProcessDirectoryConcurrently();
+        }
+    }
+
+    std::tuple<int, int, int> shard_counters{0, 0, 0};
+
+    if (!load_shards_directory_.get().empty())
+    {
+        shard_counters = this->LoadShards();
+    }
+
+    // finish off the last set so it can be loaded.
+
+    if (shard_writer_)
+    {
+        shard_writer_->Close();
+    }
+    if (fact_exporter_)
+    {
+        fact_exporter_->Close();
+    }
+
+    // if we didn't get here, the indexes stay deferred until a bulk load does.
+
+    if (bulk_load_)
+    {
+        spdlog::info("Bulk load. Rebuilding deferred indexes...");
+        auto conn = db_pool_->get_connection();
+        auto rebuilt = RebuildDeferredIndexes(*conn, schema_prefix_ + "unified_extracts", index_build_workers_);
+        spdlog::info(catenate("Bulk load. Rebuilt: ", rebuilt, " indexes."));
     }
 
     std::tuple<int, int, int> counters{0, 0, 0};
     counters = AddTs(counters, single_counters);
     counters = AddTs(counters, list_counters);
     counters = AddTs(counters, local_counters);
+    counters = AddTs(counters, shard_counters);
 
     auto [success_counter, skipped_counter, error_counter] = counters;
 
     spdlog::info(catenate("Processed: ", SumT(counters), " files. Successes: ", success_counter,
                           ". Skips: ", skipped_counter, ". Errors: ", error_counter, "."));
 
+    if (db_pool_)
+    {
+        db_pool_->log_stats();
+    }
+
     return counters;
 } /* -----  end of method ExtractorApp::Run  ----- */
 
-std::optional<ExtractorApp::FileMode> ExtractorApp::ApplyFilters(const EM::SEC_Header_fields &SEC_fields,
-                                                                 const EM::FileName &file_name,
-                                                                 const EM::DocumentSectionList &sections,
-                                                                 std::atomic<int> *forms_processed)
+bool ExtractorApp::ApplyHeaderFilters(const EM::SEC_Header_fields &SEC_fields, const EM::FileName &file_name)
 {
-    bool use_file{true};
+    // the filters in our list only look at the SEC header fields so we can run them
+    // before we have loaded and sectioned the whole file.
+
+    static const EM::DocumentSectionList no_sections;
+
     for (const auto &filter : filters_)
     {
-        use_file = std::visit([&SEC_fields, sections](auto &f) -> bool { return f(SEC_fields, sections); }, filter);
+        bool use_file =
+            std::visit([&SEC_fields](auto &f) -> bool { return f(SEC_fields, no_sections); }, filter);
         if (!use_file)
         {
             spdlog::info(catenate(file_name.get(), ": File skipped because of filter: ",
                                   std::visit([](auto &f) -> std::string { return f.filter_name_; }, filter), "."));
-            return std::nullopt;
+            return false;
         }
     }
+    return true;
+} /* -----  end of method ExtractorApp::ApplyHeaderFilters  ----- */
+
+std::optional<ExtractorApp::FileMode> ExtractorApp::ApplyFilters(const EM::SEC_Header_fields &SEC_fields,
+                                                                 const EM::FileName &file_name,
+                                                                 const EM::DocumentSectionList &sections,
+                                                                 std::atomic<int> *forms_processed)
+{
+    // header filters have already been applied. these filters need the document
+    // sections so are a little more expensive to use.
+    // also, if we find we have XBRL, don't look for HTML.
 
-    // these 2 filters are a little more expensive to use, so do after the above
-    // tests also, if we find we have XBRL, don't look for HTML.
+    bool use_file{true};
 
     if (data_source_ == "BOTH" || data_source_ == "XBRL")
     {
@@ -693,10 +894,20 @@ std::optional<ExtractorApp::FileMode> ExtractorApp::ApplyFilters(const EM::SEC_H
 std::tuple<int, int, int> ExtractorApp::LoadSingleFileToDB(const EM::FileName &input_file_name)
 {
     std::atomic<int> forms_processed{0};
+
+    if (shard_writer_ || fact_exporter_)
+    {
+        int success_counter{0};
+        int skipped_counter{0};
+        int error_counter{0};
+        Do_SingleFile(&forms_processed, success_counter, skipped_counter, error_counter, input_file_name);
+        return {success_counter, skipped_counter, error_counter};
+    }
+
     try
     {
-        const std::string content{LoadDataFileForUse(input_file_name)};
-        EM::FileContent file_content{content};
+        const MappedFile mapped_file{input_file_name};
+        EM::FileContent file_content{mapped_file.GetContent()};
         const auto document_sections = LocateDocumentSections(file_content);
 
         SEC_Header SEC_data;
@@ -704,6 +915,8 @@ std::tuple<int, int, int> ExtractorApp::LoadSingleFileToDB(const EM::FileName &i
         SEC_data.ExtractHeaderFields();
         decltype(auto) SEC_fields = SEC_data.GetFields();
 
+        [[maybe_unused]] const bool header_passes = this->ApplyHeaderFilters(SEC_fields, input_file_name);
+        BOOST_ASSERT_MSG(header_passes, "Specified file does not meet other criteria.");
         auto use_file = this->ApplyFilters(SEC_fields, input_file_name, document_sections, &forms_processed);
         BOOST_ASSERT_MSG(use_file, "Specified file does not meet other criteria.");
 
@@ -749,7 +962,12 @@ std::tuple<int, int, int> ExtractorApp::LoadSingleFileToDB_XLS(const EM::FileCon
                      catenate("Can't find any data fields in tables: ", input_file_name.get()).c_str());
 
     //        did_load = true;
-    bool did_load = LoadDataToDB_XLS(SEC_fields, the_tables, schema_prefix_ + "unified_extracts", replace_DB_content_);
+    auto conn = db_pool_->get_connection();
+    pqxx::work trxn{*conn};
+    bool did_load =
+        LoadDataToDB_XLS(SEC_fields, the_tables, trxn, schema_prefix_ + "unified_extracts", replace_DB_content_,
+                         upsert_filing_ID_);
+    trxn.commit();
     if (did_load)
     {
         return {1, 0, 0};
@@ -766,15 +984,15 @@ std::tuple<int, int, int> ExtractorApp::LoadSingleFileToDB_XBRL(const EM::FileCo
     auto labels_xml = ParseXMLContent(labels_document);
 
     auto instance_document = LocateInstanceDocument(document_sections, input_file_name);
-    auto instance_xml = ParseXMLContent(instance_document);
+    auto [filing_data, gaap_data, context_data] = ReadInstanceDocument(instance_document, input_file_name);
 
-    auto filing_data = ExtractFilingData(instance_xml);
-    auto gaap_data = ExtractGAAPFields(instance_xml);
-    auto context_data = ExtractContextDefinitions(instance_xml);
     auto label_data = ExtractFieldLabels(labels_xml);
 
-    bool did_load = LoadDataToDB(SEC_fields, filing_data, gaap_data, label_data, context_data,
-                                 schema_prefix_ + "unified_extracts", replace_DB_content_);
+    auto conn = db_pool_->get_connection();
+    pqxx::work trxn{*conn};
+    bool did_load = LoadDataToDB(SEC_fields, filing_data, gaap_data, label_data, context_data, trxn,
+                                 schema_prefix_ + "unified_extracts", replace_DB_content_, upsert_filing_ID_);
+    trxn.commit();
 
     if (did_load)
     {
@@ -791,8 +1009,9 @@ std::tuple<int, int, int> ExtractorApp::LoadSingleFileToDB_HTML(const EM::FileCo
 {
     if (update_shares_outstanding_)
     {
-        UpdateOutstandingShares(so_, document_sections, SEC_fields, form_list_, schema_prefix_ + "unified_extracts",
-                                input_file_name);
+        auto conn = db_pool_->get_connection();
+        UpdateOutstandingShares(so_, document_sections, SEC_fields, form_list_, conn,
+                                schema_prefix_ + "unified_extracts", input_file_name);
         return {1, 0, 0};
     }
 
@@ -813,7 +1032,12 @@ std::tuple<int, int, int> ExtractorApp::LoadSingleFileToDB_HTML(const EM::FileCo
                      catenate("Can't find any data fields in tables: ", input_file_name.get()).c_str());
 
     //        did_load = true;
-    bool did_load = LoadDataToDB(SEC_fields, the_tables, schema_prefix_ + "unified_extracts", replace_DB_content_);
+    auto conn = db_pool_->get_connection();
+    pqxx::work trxn{*conn};
+    bool did_load =
+        LoadDataToDB(SEC_fields, the_tables, trxn, schema_prefix_ + "unified_extracts", replace_DB_content_,
+                     upsert_filing_ID_);
+    trxn.commit();
     if (did_load)
     {
         return {1, 0, 0};
@@ -895,7 +1119,7 @@ bool ExtractorApp::ExportHtmlFromSingleFile(const EM::DocumentSectionList &secti
         exported_file.put('\n');
 
         errno = 0;
-        exported_file.write(financial_content->document_.get().data(), financial_content->document_.get().size());
+        exported_file.write(financial_content->document_.content_.data(), financial_content->document_.content_.size());
         exported_file.close();
         if (exported_file.fail())
         {
@@ -935,38 +1159,16 @@ void ExtractorApp::Do_SingleFile(std::atomic<int> *forms_processed, int &success
     {
         try
         {
-            if (filename_has_form_)
-            {
-                if (!FormIsInFileName(form_list_, file_name))
-                {
-                    ++skipped_counter;
-                    spdlog::info(catenate(file_name.get(),
-                                          ": File skipped because path is supposed to "
-                                          "contain form name but doesn't."));
-                    return;
-                }
-            }
-            spdlog::info(catenate("Scanning file: ", file_name.get()));
-            const std::string content{LoadDataFileForUse(file_name)};
-            EM::FileContent file_content{content};
-            const auto document_sections = LocateDocumentSections(file_content);
-
-            SEC_Header SEC_data;
-            SEC_data.UseData(file_content);
-            SEC_data.ExtractHeaderFields();
-            decltype(auto) SEC_fields = SEC_data.GetFields();
-            auto sec_header = SEC_data.GetHeader();
-
-            if (auto use_file = this->ApplyFilters(SEC_fields, file_name, document_sections, forms_processed); use_file)
-            {
-                LoadFileFromFolderToDB(file_name, SEC_fields, document_sections, sec_header, use_file.value())
-                    ? ++success_counter
-                    : ++skipped_counter;
-            }
-            else
+            auto filing = this->ReadFiling(file_name, forms_processed);
+            if (!filing)
             {
                 ++skipped_counter;
+                return;
             }
+
+            this->ExtractFilingContent(filing.value());
+
+            this->StoreFilingContent(filing.value()) ? ++success_counter : ++skipped_counter;
         }
         catch (const MaxFilesException &e)
         {
@@ -1024,81 +1226,98 @@ std::tuple<int, int, int> ExtractorApp::ProcessDirectory()
     return {success_counter, skipped_counter, error_counter};
 } /* -----  end of method ExtractorApp::ProcessDirectory  ----- */
 
-bool ExtractorApp::LoadFileFromFolderToDB(const EM::FileName &file_name, const EM::SEC_Header_fields &SEC_fields,
-                                          const EM::DocumentSectionList &sections, EM::sv sec_header,
-                                          FileMode file_mode, std::mutex *db_mutex)
+std::optional<ExtractorApp::FilingInProcess> ExtractorApp::ReadFiling(const EM::FileName &file_name,
+                                                                      std::atomic<int> *forms_processed)
 {
-    spdlog::info(catenate("Loading contents from file: ", file_name.get()));
-
-    if (file_mode == FileMode::e_XLS)
+    if (filename_has_form_)
     {
-        return LoadFileFromFolderToDB_XLS(file_name, SEC_fields, sections, sec_header, db_mutex);
+        if (!FormIsInFileName(form_list_, file_name))
+        {
+            spdlog::info(catenate(file_name.get(),
+                                  ": File skipped because path is supposed to "
+                                  "contain form name but doesn't."));
+            return std::nullopt;
+        }
     }
-    if (file_mode == FileMode::e_XBRL)
+
+    spdlog::info(catenate("Scanning file: ", file_name.get()));
+
+    // look at just the SEC header first. most files we skip can be rejected
+    // without loading the whole thing.
+
+    const std::string header_content = LoadSECHeaderForUse(file_name);
+
+    SEC_Header SEC_data;
+    SEC_data.UseData(EM::FileContent{header_content});
+    SEC_data.ExtractHeaderFields();
+
+    if (!this->ApplyHeaderFilters(SEC_data.GetFields(), file_name))
     {
-        return LoadFileFromFolderToDB_XBRL(file_name, SEC_fields, sections, db_mutex);
+        return std::nullopt;
     }
-    return LoadFileFromFolderToDB_HTML(file_name, SEC_fields, sections, sec_header, db_mutex);
-} /* -----  end of method ExtractorApp::LoadFileFromFolderToDB  ----- */
 
-bool ExtractorApp::LoadFileFromFolderToDB_XLS(const EM::FileName &file_name, const EM::SEC_Header_fields &SEC_fields,
-                                              const EM::DocumentSectionList &sections, EM::sv sec_header,
-                                              std::mutex *db_mutex)
-{
-    // TODO: check for and handle exporting spreadsheets.
+    FilingInProcess filing{.file_name_ = file_name, .mapped_file_ = MappedFile{file_name}};
+    EM::FileContent file_content{filing.mapped_file_.GetContent()};
+    filing.document_sections_ = LocateDocumentSections(file_content);
 
-    auto the_tables = FindAndExtractXLSContent(sections, file_name);
-    BOOST_ASSERT_MSG(the_tables.has_data(),
-                     catenate("Can't find required XLS financial tables: ", file_name.get()).c_str());
+    // re-point the header at the full content. the parsed fields are already in place.
 
-    BOOST_ASSERT_MSG(the_tables.ValuesTotal() > 0,
-                     catenate("Can't find any data fields in tables: ", file_name.get()).c_str());
-    if (db_mutex == nullptr)
+    SEC_data.UseData(file_content);
+    filing.sec_header_ = SEC_data.GetHeader();
+    filing.SEC_fields_ = SEC_data.GetFields();
+
+    auto use_file = this->ApplyFilters(filing.SEC_fields_, file_name, filing.document_sections_, forms_processed);
+    if (!use_file)
     {
-        return LoadDataToDB_XLS(SEC_fields, the_tables, schema_prefix_ + "unified_extracts", replace_DB_content_);
+        spdlog::info(catenate("Skipping file: ", file_name.get(), " Failed to meet criteria."));
+        return std::nullopt;
     }
-    std::lock_guard<std::mutex> lock(*db_mutex);
-    return LoadDataToDB_XLS(SEC_fields, the_tables, schema_prefix_ + "unified_extracts", replace_DB_content_);
+    filing.file_mode_ = use_file.value();
 
-} /* -----  end of method ExtractorApp::LoadFileFromFolderToDB_HTML  ----- */
+    return filing;
+} /* -----  end of method ExtractorApp::ReadFiling  ----- */
 
-bool ExtractorApp::LoadFileFromFolderToDB_XBRL(const EM::FileName &file_name, const EM::SEC_Header_fields &SEC_fields,
-                                               const EM::DocumentSectionList &document_sections, std::mutex *db_mutex)
+void ExtractorApp::ExtractFilingContent(FilingInProcess &filing)
 {
-    auto labels_document = LocateLabelDocument(document_sections, file_name);
-    auto labels_xml = ParseXMLContent(labels_document);
+    const auto &file_name = filing.file_name_;
+    const auto &sections = filing.document_sections_;
 
-    auto instance_document = LocateInstanceDocument(document_sections, file_name);
-    auto instance_xml = ParseXMLContent(instance_document);
+    if (filing.file_mode_ == FileMode::e_XLS)
+    {
+        // TODO: check for and handle exporting spreadsheets.
 
-    auto filing_data = ExtractFilingData(instance_xml);
-    auto gaap_data = ExtractGAAPFields(instance_xml);
-    auto context_data = ExtractContextDefinitions(instance_xml);
-    auto label_data = ExtractFieldLabels(labels_xml);
+        auto the_tables = FindAndExtractXLSContent(sections, file_name);
+        BOOST_ASSERT_MSG(the_tables.has_data(),
+                         catenate("Can't find required XLS financial tables: ", file_name.get()).c_str());
 
-    if (db_mutex == nullptr)
-    {
-        return LoadDataToDB(SEC_fields, filing_data, gaap_data, label_data, context_data,
-                            schema_prefix_ + "unified_extracts", replace_DB_content_);
+        BOOST_ASSERT_MSG(the_tables.ValuesTotal() > 0,
+                         catenate("Can't find any data fields in tables: ", file_name.get()).c_str());
+
+        filing.content_ = std::move(the_tables);
+        return;
     }
-    std::lock_guard<std::mutex> lock(*db_mutex);
-    return LoadDataToDB(SEC_fields, filing_data, gaap_data, label_data, context_data,
-                        schema_prefix_ + "unified_extracts", replace_DB_content_);
-} /* -----  end of method ExtractorApp::LoadFileFromFolderToDB_XBRL  ----- */
 
-bool ExtractorApp::LoadFileFromFolderToDB_HTML(const EM::FileName &file_name, const EM::SEC_Header_fields &SEC_fields,
-                                               const EM::DocumentSectionList &sections, EM::sv sec_header,
-                                               std::mutex *db_mutex)
-{
-    if (update_shares_outstanding_)
+    if (filing.file_mode_ == FileMode::e_XBRL)
     {
-        UpdateOutstandingShares(so_, sections, SEC_fields, form_list_, schema_prefix_ + "unified_extracts", file_name);
-        return true;
+        auto labels_document = LocateLabelDocument(sections, file_name);
+        auto labels_xml = ParseXMLContent(labels_document);
+
+        auto instance_document = LocateInstanceDocument(sections, file_name);
+        auto instance_data = ReadInstanceDocument(instance_document, file_name);
+
+        filing.content_ = XBRL_Extracts{.filing_data_ = std::move(instance_data.filing_data_),
+                                        .gaap_data_ = std::move(instance_data.gaap_data_),
+                                        .label_data_ = ExtractFieldLabels(labels_xml),
+                                        .context_data_ = std::move(instance_data.context_data_)};
+        return;
     }
 
-    if (export_HTML_forms_)
+    // updating shares outstanding and exporting work straight from the
+    // document sections when we store the filing.
+
+    if (update_shares_outstanding_ || export_HTML_forms_)
     {
-        return ExportHtmlFromSingleFile(sections, file_name, sec_header);
+        return;
     }
 
     auto the_tables = FindAndExtractFinancialStatements(so_, &sections, form_list_, file_name);
@@ -1107,72 +1326,239 @@ bool ExtractorApp::LoadFileFromFolderToDB_HTML(const EM::FileName &file_name, co
 
     BOOST_ASSERT_MSG(the_tables.ValuesTotal() > 0,
                      catenate("Can't find any data fields in tables: ", file_name.get()).c_str());
-    if (db_mutex == nullptr)
+
+    filing.content_ = std::move(the_tables);
+} /* -----  end of method ExtractorApp::ExtractFilingContent  ----- */
+
+bool ExtractorApp::StoreFilingContent(FilingInProcess &filing)
+{
+    const auto &file_name = filing.file_name_;
+
+    if (filing.file_mode_ == FileMode::e_HTML)
     {
-        return LoadDataToDB(SEC_fields, the_tables, schema_prefix_ + "unified_extracts", replace_DB_content_);
+        if (update_shares_outstanding_)
+        {
+            auto conn = db_pool_->get_connection();
+            UpdateOutstandingShares(so_, filing.document_sections_, filing.SEC_fields_, form_list_, conn,
+                                    schema_prefix_ + "unified_extracts", file_name);
+            return true;
+        }
+
+        if (export_HTML_forms_)
+        {
+            return ExportHtmlFromSingleFile(filing.document_sections_, file_name, filing.sec_header_);
+        }
     }
-    std::lock_guard<std::mutex> lock(*db_mutex);
-    return LoadDataToDB(SEC_fields, the_tables, schema_prefix_ + "unified_extracts", replace_DB_content_);
-} /* -----  end of method ExtractorApp::LoadFileFromFolderToDB_HTML  ----- */
 
-std::tuple<int, int, int> ExtractorApp::LoadFileAsync(const EM::FileName &file_name, std::atomic<int> *forms_processed,
-                                                      std::mutex *db_mutex)
+    if (shard_writer_)
+    {
+        return WriteFilingShards(filing, *shard_writer_);
+    }
+    if (fact_exporter_)
+    {
+        return WriteFilingFacts(filing, *fact_exporter_);
+    }
+
+    auto conn = db_pool_->get_connection();
+    pqxx::work trxn{*conn};
+    bool did_load = WriteFilingContent(filing, trxn);
+    trxn.commit();
+    return did_load;
+} /* -----  end of method ExtractorApp::StoreFilingContent  ----- */
+
+bool ExtractorApp::WriteFilingContent(FilingInProcess &filing, pqxx::dbtransaction &trxn)
 {
-    int success_counter{0};
-    int skipped_counter{0};
-    int error_counter{0};
+    const auto &file_name = filing.file_name_;
+    const auto &SEC_fields = filing.SEC_fields_;
 
-    if (filename_has_form_)
+    spdlog::info(catenate("Loading contents from file: ", file_name.get()));
+
+    if (const auto *the_tables = std::get_if<XLS_FinancialStatements>(&filing.content_))
     {
-        if (!FormIsInFileName(form_list_, file_name))
+        return LoadDataToDB_XLS(SEC_fields, *the_tables, trxn, schema_prefix_ + "unified_extracts",
+                                replace_DB_content_, upsert_filing_ID_);
+    }
+    if (const auto *xbrl_data = std::get_if<XBRL_Extracts>(&filing.content_))
+    {
+        return LoadDataToDB(SEC_fields, xbrl_data->filing_data_, xbrl_data->gaap_data_, xbrl_data->label_data_,
+                            xbrl_data->context_data_, trxn, schema_prefix_ + "unified_extracts",
+                            replace_DB_content_, upsert_filing_ID_);
+    }
+    if (const auto *the_tables = std::get_if<FinancialStatements>(&filing.content_))
+    {
+        return LoadDataToDB(SEC_fields, *the_tables, trxn, schema_prefix_ + "unified_extracts", replace_DB_content_,
+                            upsert_filing_ID_);
+    }
+    throw ExtractorException(catenate("No extracted content to store for file: ", file_name.get()));
+} /* -----  end of method ExtractorApp::WriteFilingContent  ----- */
+
+bool ExtractorApp::WriteFilingShards(FilingInProcess &filing, ShardWriter &shard_writer)
+{
+    const auto &file_name = filing.file_name_;
+    const auto &SEC_fields = filing.SEC_fields_;
+
+    spdlog::info(catenate("Writing shard rows from file: ", file_name.get()));
+
+    // don't leave part of a filing behind if we fail along the way.
+
+    try
+    {
+        if (const auto *the_tables = std::get_if<XLS_FinancialStatements>(&filing.content_))
         {
-            ++skipped_counter;
-            spdlog::debug(catenate(file_name.get(),
-                                   ": File skipped because path is supposed "
-                                   "to contain form name but doesn't."));
-            return {success_counter, skipped_counter, error_counter};
+            WriteDataToShards_XLS(SEC_fields, *the_tables, shard_writer);
+            return true;
+        }
+        if (const auto *xbrl_data = std::get_if<XBRL_Extracts>(&filing.content_))
+        {
+            WriteDataToShards(SEC_fields, xbrl_data->filing_data_, xbrl_data->gaap_data_, xbrl_data->label_data_,
+                              xbrl_data->context_data_, shard_writer);
+            return true;
+        }
+        if (const auto *the_tables = std::get_if<FinancialStatements>(&filing.content_))
+        {
+            WriteDataToShards(SEC_fields, *the_tables, shard_writer);
+            return true;
         }
     }
+    catch (...)
+    {
+        shard_writer.DropFiling();
+        throw;
+    }
+    throw ExtractorException(catenate("No extracted content to store for file: ", file_name.get()));
+} /* -----  end of method ExtractorApp::WriteFilingShards  ----- */
 
-    spdlog::info(catenate("Scanning file: ", file_name.get()));
-    const std::string content(LoadDataFileForUse(file_name));
-    EM::FileContent file_content{content};
-    const auto document_sections = LocateDocumentSections(file_content);
+bool ExtractorApp::WriteFilingFacts(FilingInProcess &filing, FactExporter &fact_exporter)
+{
+    const auto &file_name = filing.file_name_;
+    const auto &SEC_fields = filing.SEC_fields_;
 
-    SEC_Header SEC_data;
-    SEC_data.UseData(file_content);
-    SEC_data.ExtractHeaderFields();
-    decltype(auto) SEC_fields = SEC_data.GetFields();
-    auto sec_header = SEC_data.GetHeader();
+    spdlog::info(catenate("Exporting facts from file: ", file_name.get()));
 
-    if (auto use_file = this->ApplyFilters(SEC_fields, file_name, document_sections, forms_processed); use_file)
+    try
     {
-        try
+        if (const auto *the_tables = std::get_if<XLS_FinancialStatements>(&filing.content_))
         {
-            LoadFileFromFolderToDB(file_name, SEC_fields, document_sections, sec_header, use_file.value(), db_mutex)
-                ? ++success_counter
-                : ++skipped_counter;
+            ExportFacts_XLS(SEC_fields, *the_tables, fact_exporter);
+            return true;
         }
-        catch (const pqxx::failure &e)
+        if (const auto *xbrl_data = std::get_if<XBRL_Extracts>(&filing.content_))
         {
-            // need to log name of file which failed
+            ExportFacts(SEC_fields, xbrl_data->filing_data_, xbrl_data->gaap_data_, xbrl_data->label_data_,
+                        xbrl_data->context_data_, fact_exporter);
+            return true;
+        }
+        if (const auto *the_tables = std::get_if<FinancialStatements>(&filing.content_))
+        {
+            ExportFacts(SEC_fields, *the_tables, fact_exporter);
+            return true;
+        }
+    }
+    catch (...)
+    {
+        fact_exporter.DropFiling();
+        throw;
+    }
+    throw ExtractorException(catenate("No extracted content to store for file: ", file_name.get()));
+} /* -----  end of method ExtractorApp::WriteFilingFacts  ----- */
 
-            spdlog::error(catenate("Problem adding file content to DB: ", file_name.get(), '\n', e.what()));
+// how many data rows a filing adds. used to size commit batches.
 
-            auto eptr = std::current_exception();
-            std::rethrow_exception(eptr);
-        }
+size_t ExtractorApp::FilingRowCount(FilingInProcess &filing)
+{
+    if (auto *the_tables = std::get_if<XLS_FinancialStatements>(&filing.content_))
+    {
+        return the_tables->ValuesTotal();
     }
-    else
+    if (const auto *xbrl_data = std::get_if<XBRL_Extracts>(&filing.content_))
     {
-        spdlog::info(catenate("Skipping file: ", file_name.get(), " Failed to meet criteria."));
-        ++skipped_counter;
+        return xbrl_data->gaap_data_.size();
     }
+    if (auto *the_tables = std::get_if<FinancialStatements>(&filing.content_))
+    {
+        return the_tables->ValuesTotal();
+    }
+    return 0;
+} /* -----  end of method ExtractorApp::FilingRowCount  ----- */
 
-    return {success_counter, skipped_counter, error_counter};
-} /* -----  end of method ExtractorApp::LoadFileAsync  ----- */
+// files which load the same filing -- an original and its amendments -- all land
+// on the same DB rows so they must not be loaded at the same time. the key uses
+// the period ending the filing's sec_filing_id row is written with: the instance
+// document's period end date for XBRL, the header's quarter ending otherwise.
+// NOTE: an XBRL replace still deletes by the header's quarter ending so, in the
+// rare filing where the 2 dates differ, that delete isn't covered by the lock.
+
+std::string ExtractorApp::FilingLockID(const FilingInProcess &filing)
+{
+    if (const auto *xbrl_data = std::get_if<XBRL_Extracts>(&filing.content_))
+    {
+        return FilingKey(filing.SEC_fields_, xbrl_data->filing_data_.period_end_date);
+    }
+    return FilingKey(filing.SEC_fields_);
+} /* -----  end of method ExtractorApp::FilingLockID  ----- */
+
+XBRL_InstanceData ExtractorApp::ReadInstanceDocument(EM::XBRLContent instance_document,
+                                                     const EM::FileName &file_name) const
+{
+    auto instance_data = ExtractInstanceData(instance_document);
+    if (!verify_instance_reader_)
+    {
+        return instance_data;
+    }
+
+    auto differences = CompareWithDOM(instance_document, instance_data);
+    if (!differences.empty())
+    {
+        for (const auto &difference : differences)
+        {
+            spdlog::error(catenate("Instance reader: ", difference));
+        }
+        throw XBRLException(catenate("Instance reader and DOM differ in: ", differences.size(),
+                                     " places for file: ", file_name.get().string()));
+    }
+    return instance_data;
+} /* -----  end of method ExtractorApp::ReadInstanceDocument  ----- */
 
 std::tuple<int, int, int> ExtractorApp::LoadFilesFromListToDBConcurrently()
+{
+    size_t current_file{0};
+
+    auto next_file = [this, &current_file]() -> std::optional<EM::FileName> {
+        if (current_file < list_of_files_to_process_.size())
+        {
+            return EM::FileName{list_of_files_to_process_[current_file++]};
+        }
+        return std::nullopt;
+    };
+
+    return LoadFilesConcurrently(next_file);
+} /* -----  end of method ExtractorApp::LoadFilesFromListToDBConcurrently  ----- */
+
+std::tuple<int, int, int> ExtractorApp::ProcessDirectoryConcurrently()
+{
+    // we walk the directory tree as we go rather than up front so the workers
+    // can get started on the first files while we look for the rest.
+
+    fs::recursive_directory_iterator current_entry{local_form_file_directory_.get()};
+
+    auto next_file = [&current_entry]() -> std::optional<EM::FileName> {
+        for (; current_entry != fs::recursive_directory_iterator{}; ++current_entry)
+        {
+            if (current_entry->status().type() == fs::file_type::regular)
+            {
+                EM::FileName file_name{current_entry->path()};
+                ++current_entry;
+                return file_name;
+            }
+        }
+        return std::nullopt;
+    };
+
+    return LoadFilesConcurrently(next_file);
+} /* -----  end of method ExtractorApp::ProcessDirectoryConcurrently  ----- */
+
+std::tuple<int, int, int> ExtractorApp::LoadFilesConcurrently(
+    const std::function<std::optional<EM::FileName>()> &next_file)
 {
     // since this code can potentially run for hours on end (depending on database
     // throughput) it's a good idea to provide a way to break into this processing
@@ -1199,49 +1585,46 @@ std::tuple<int, int, int> ExtractorApp::LoadFilesFromListToDBConcurrently()
     std::exception_ptr ep{nullptr};
 
     std::tuple<int, int, int> counters{0, 0, 0}; // success, skips, errors
+    std::mutex counters_mutex;
 
-    std::atomic<int> forms_processed{0};
-
-    // keep track of our async processes here.
+    std::atomic<bool> stop_processing{false};
 
-    std::vector<std::future<std::tuple<int, int, int>>> tasks;
-    tasks.reserve(max_at_a_time_);
+    std::atomic<int> forms_processed{0};
 
     // use this to manage potential concurrent access when processing amended
-    // forms.
+    // forms. only files for the same filing wait on each other.
 
-    std::mutex db_mutex;
-    //    ExtractMutex active_forms;
+    ExtractMutex active_forms;
 
-    // prime the pump...
+    // each file goes through 3 stages: read (mostly I/O plus the DB existence check),
+    // extract (all CPU) and store (mostly waiting on the DB). each stage has its own
+    // threads and hands off to the next through a bounded queue so each can be sized
+    // separately. when a queue fills up, the stage feeding it waits.
 
-    size_t current_file{0};
-    for (; tasks.size() < max_at_a_time_ && current_file < list_of_files_to_process_.size(); ++current_file)
-    {
-        // queue up our tasks up to the limit.
+    const int read_threads = std::max(1, read_threads_);
+    const int extract_threads =
+        extract_threads_ > 0 ? extract_threads_ : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int store_threads = max_at_a_time_;
 
-        tasks.emplace_back(std::async(std::launch::async, &ExtractorApp::LoadFileAsync, this,
-                                      EM::FileName{list_of_files_to_process_[current_file]}, &forms_processed,
-                                      &db_mutex));
-    }
+    BoundedQueue<EM::FileName> files_to_read{static_cast<size_t>(2 * read_threads)};
+    BoundedQueue<FilingInProcess> filings_to_extract{static_cast<size_t>(2 * extract_threads)};
+    BoundedQueue<FilingInProcess> filings_to_store{static_cast<size_t>(2 * store_threads)};
 
-    int continue_here{0};
-    int ready_task{-1};
+    // once we decide to stop, whatever is already in a queue is dropped but
+    // work in process is finished.
 
-    for (; current_file < list_of_files_to_process_.size(); ++current_file)
-    {
-        // we want to keep max_at_a_time_ tasks going so, as one finishes,
-        // we replace it with another
+    auto stopping = [&stop_processing]() { return stop_processing || ExtractorApp::had_signal_; };
 
-        ready_task = wait_for_any(tasks, continue_here, std::chrono::microseconds{100});
-        if (ready_task < 0)
+    auto record_result = [&](const std::tuple<int, int, int> &result, std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(counters_mutex);
+        counters = AddTs(counters, result);
+        if (!error)
         {
-            break;
+            return;
         }
         try
         {
-            auto result = tasks[ready_task].get();
-            counters = AddTs(counters, result);
+            std::rethrow_exception(error);
         }
         catch (const std::system_error &e)
         {
@@ -1250,119 +1633,309 @@ std::tuple<int, int, int> ExtractorApp::LoadFilesFromListToDBConcurrently()
 
             spdlog::error(e.what());
             auto ec = e.code();
-            spdlog::error(
-                catenate("Category: ", ec.category().name(), ". Value: ", ec.value(), ". Message: ", ec.message()));
-            counters = AddTs(counters, {0, 0, 1});
+            spdlog::error(catenate("Category: ", ec.category().name(), ". Value: ", ec.value(),
+                                   ". Message: ", ec.message()));
 
             // OK, let's be sure this propagates
 
-            ep = std::current_exception();
-            break;
+            if (!ep)
+            {
+                ep = error;
+            }
+            stop_processing = true;
         }
         catch (const MaxFilesException &e)
         {
-            // any 'expected' problems, we'll document them and continue on.
-
             spdlog::error(e.what());
-            counters = AddTs(counters, {0, 0, 1});
 
             if (!ep)
             {
-                ep = std::current_exception();
+                ep = error;
             }
-            break;
+            stop_processing = true;
         }
         catch (const pqxx::failure &e)
         {
             spdlog::error(catenate("Database error: ", e.what()));
-            counters = AddTs(counters, {0, 0, 1});
         }
         catch (const std::exception &e)
         {
             // any 'expected' problems, we'll document them and continue on.
 
             spdlog::error(e.what());
-            counters = AddTs(counters, {0, 0, 1});
         }
         catch (...)
         {
             // any other problems, we'll document them and stop.
 
             spdlog::error("Unknown problem with async file processing. Stopping...");
-            counters = AddTs(counters, {0, 0, 1});
 
             // OK, let's remember our first time here.
 
             if (!ep)
             {
-                ep = std::current_exception();
+                ep = error;
             }
-            break;
+            stop_processing = true;
         }
+    };
 
-        if (ExtractorApp::had_signal_)
+    auto read_files = [&]() {
+        while (auto file_name = files_to_read.pop())
         {
-            break;
+            if (stopping())
+            {
+                continue;
+            }
+            try
+            {
+                auto filing = this->ReadFiling(file_name.value(), &forms_processed);
+                if (!filing)
+                {
+                    record_result({0, 1, 0}, nullptr);
+                    continue;
+                }
+                filings_to_extract.push(std::move(filing.value()));
+            }
+            catch (...)
+            {
+                record_result({0, 0, 1}, std::current_exception());
+            }
         }
+    };
 
-        //  let's keep going
-
-        if (current_file < list_of_files_to_process_.size())
+    auto extract_content = [&]() {
+        while (auto filing = filings_to_extract.pop())
         {
-            tasks[ready_task] =
-                std::async(std::launch::async, &ExtractorApp::LoadFileAsync, this,
-                           EM::FileName{list_of_files_to_process_[current_file]}, &forms_processed, &db_mutex);
-            continue_here = (ready_task + 1) % max_at_a_time_;
-            ready_task = -1;
+            if (stopping())
+            {
+                continue;
+            }
+            try
+            {
+                this->ExtractFilingContent(filing.value());
+                filings_to_store.push(std::move(filing.value()));
+            }
+            catch (...)
+            {
+                record_result({0, 0, 1}, std::current_exception());
+            }
         }
-    }
+    };
 
-    // need to clean up the last set of tasks
-    for (int i = 0; i < max_at_a_time_; ++i)
-    {
-        try
+    // filings are committed in batches. a filing's result isn't known until its batch commits.
+
+    auto store_content = [&]() {
+        GroupCommitWriter writer{db_pool_.get(), &active_forms, static_cast<size_t>(std::max(0, batch_rows_)),
+                                 std::chrono::milliseconds{batch_ms_}};
+
+        while (true)
         {
-            if (ready_task > -1 && i == ready_task)
+            // wait as long as it takes for the first filing in a batch but only
+            // as long as the batch can wait for the rest.
+
+            std::optional<FilingInProcess> filing;
+            if (writer.empty())
+            {
+                filing = filings_to_store.pop();
+                if (!filing)
+                {
+                    break;
+                }
+            }
+            else
+            {
+                filing = filings_to_store.pop_for(writer.TimeLeft());
+                if (!filing)
+                {
+                    writer.Flush();
+                    continue;
+                }
+            }
+
+            if (stopping())
             {
                 continue;
             }
-            if (tasks[i].valid())
+
+            if (update_shares_outstanding_ || export_HTML_forms_)
             {
-                auto result = tasks[i].get();
-                counters = AddTs(counters, result);
+                try
+                {
+                    bool did_load = this->StoreFilingContent(filing.value());
+                    record_result(did_load ? std::tuple{1, 0, 0} : std::tuple{0, 1, 0}, nullptr);
+                }
+                catch (...)
+                {
+                    record_result({0, 0, 1}, std::current_exception());
+                }
+                continue;
             }
+
+            auto filing_done = [&record_result, file_name = filing->file_name_](bool did_load,
+                                                                                std::exception_ptr error) {
+                if (error)
+                {
+                    // need to log name of file which failed
+
+                    spdlog::error(catenate("Problem adding file content to DB: ", file_name.get()));
+                    record_result({0, 0, 1}, error);
+                    return;
+                }
+                record_result(did_load ? std::tuple{1, 0, 0} : std::tuple{0, 1, 0}, nullptr);
+            };
+
+            writer.Add(
+                FilingLockID(filing.value()), FilingRowCount(filing.value()),
+                [this, &filing](pqxx::dbtransaction &trxn) { return this->WriteFilingContent(filing.value(), trxn); },
+                filing_done);
         }
-        catch (const ExtractorException &e)
-        {
-            // any problems, we'll document them and continue.
+        writer.Flush();
+    };
 
-            spdlog::error(e.what());
-            counters = AddTs(counters, {0, 0, 1});
+    // no DB and no batches when writing shards. each worker writes its own sets.
 
-            // we ignore these...
+    auto store_in_shards = [&](int worker) {
+        ShardWriter shard_writer{output_shards_directory_.get(), worker, static_cast<size_t>(shard_MB_) * 1024 * 1024};
 
-            continue;
+        while (auto filing = filings_to_store.pop())
+        {
+            if (stopping())
+            {
+                continue;
+            }
+            try
+            {
+                bool did_write = this->WriteFilingShards(filing.value(), shard_writer);
+                record_result(did_write ? std::tuple{1, 0, 0} : std::tuple{0, 1, 0}, nullptr);
+            }
+            catch (...)
+            {
+                spdlog::error(catenate("Problem writing file content to shards: ", filing->file_name_.get()));
+                record_result({0, 0, 1}, std::current_exception());
+            }
         }
-        catch (const std::exception &e)
+        shard_writer.Close();
+    };
+
+    auto store_facts = [&](int worker) {
+        FactExporter fact_exporter{export_facts_directory_.get(), worker};
+
+        while (auto filing = filings_to_store.pop())
         {
-            counters = AddTs(counters, {0, 0, 1});
-            spdlog::error(e.what());
+            if (stopping())
+            {
+                continue;
+            }
+            try
+            {
+                bool did_write = this->WriteFilingFacts(filing.value(), fact_exporter);
+                record_result(did_write ? std::tuple{1, 0, 0} : std::tuple{0, 1, 0}, nullptr);
+            }
+            catch (...)
+            {
+                spdlog::error(catenate("Problem exporting facts from file: ", filing->file_name_.get()));
+                record_result({0, 0, 1}, std::current_exception());
+            }
+        }
+
+        // the filings still held are written now. if that fails they were
+        // counted as exported but aren't so it has to be reported.
+
+        try
+        {
+            fact_exporter.Close();
         }
         catch (...)
         {
-            // any other problems, we'll document them and stop.
+            spdlog::error(catenate("Problem writing fact export files for store worker: ", worker));
+            record_result({0, 0, 0}, std::current_exception());
+        }
+    };
 
-            spdlog::error("Unknown problem with async file clean-up. ");
-            counters = AddTs(counters, {0, 0, 1});
+    spdlog::info(catenate("Concurrent load using: ", read_threads, " read, ", extract_threads, " extract and ",
+                          store_threads, " store threads."));
 
-            // OK, let's remember our first time here.
+    std::vector<std::jthread> readers;
+    std::vector<std::jthread> extractors;
+    std::vector<std::jthread> storers;
 
-            if (!ep)
+    for (int i = 0; i < read_threads; ++i)
+    {
+        readers.emplace_back(read_files);
+    }
+    for (int i = 0; i < extract_threads; ++i)
+    {
+        extractors.emplace_back(extract_content);
+    }
+    for (int i = 0; i < store_threads; ++i)
+    {
+        if (shard_writer_)
+        {
+            storers.emplace_back(store_in_shards, i + 1);
+        }
+        else if (fact_exporter_)
+        {
+            storers.emplace_back(store_facts, i + 1);
+        }
+        else
+        {
+            storers.emplace_back(store_content);
+        }
+    }
+
+    // feed the pipeline until we run out of files or have a reason to quit.
+    // if finding the next file fails (an unreadable directory, say), the workers
+    // are still waiting on their queues so we have to shut them down before
+    // passing the problem along or we would wait on them forever.
+
+    try
+    {
+        while (!stopping())
+        {
+            auto file_name = next_file();
+            if (!file_name)
             {
-                ep = std::current_exception();
+                break;
             }
+            files_to_read.push(std::move(file_name.value()));
         }
     }
+    catch (...)
+    {
+        stop_processing = true;
+
+        files_to_read.close();
+        filings_to_extract.close();
+        filings_to_store.close();
+        readers.clear();
+        extractors.clear();
+        storers.clear();
+
+        sigaction(SIGINT, &sa_old, 0);
+        throw;
+    }
+
+    // now, shut down each stage in turn. clearing the thread list waits for
+    // its threads to finish what they have.
+
+    files_to_read.close();
+    readers.clear();
+    filings_to_extract.close();
+    extractors.clear();
+    filings_to_store.close();
+    storers.clear();
+
+    auto log_queue_metrics = [](EM::sv stage_name, const auto &queue) {
+        auto metrics = queue.GetMetrics();
+        spdlog::info("Queue to {} stage. Capacity: {}. Items: {}. Max depth: {}. Average depth: {:.1f}. Waits when "
+                     "full: {}.",
+                     stage_name, metrics.capacity_, metrics.items_, metrics.max_depth_, metrics.average_depth_,
+                     metrics.full_waits_);
+    };
+    log_queue_metrics("read", files_to_read);
+    log_queue_metrics("extract", filings_to_extract);
+    log_queue_metrics("store", filings_to_store);
 
     auto [success_counter, skipped_counter, error_counter] = counters;
 
@@ -1388,8 +1961,61 @@ std::tuple<int, int, int> ExtractorApp::LoadFilesFromListToDBConcurrently()
 
     return counters;
 
-} /* -----  end of method ExtractorApp::LoadFilesFromListToDBConcurrently  -----
-   */
+} /* -----  end of method ExtractorApp::LoadFilesConcurrently  ----- */
+
+std::tuple<int, int, int> ExtractorApp::LoadShards()
+{
+    // each set is loaded and committed on its own so one bad set doesn't
+    // hold up the rest and a re-run only has to pick up what's left.
+
+    const auto shard_sets = FindShardSetsToLoad(load_shards_directory_.get());
+    const int load_threads = std::max(1, std::min<int>(max_at_a_time_, shard_sets.size()));
+
+    spdlog::info(catenate("Found: ", shard_sets.size(), " shard sets to load using: ", load_threads, " threads."));
+
+    std::tuple<int, int, int> counters{0, 0, 0}; // filings stored, filings skipped, sets with errors
+    std::mutex counters_mutex;
+    std::atomic<size_t> next_set{0};
+
+    auto load_sets = [&]() {
+        for (size_t i = next_set++; i < shard_sets.size(); i = next_set++)
+        {
+            const auto &set_path = shard_sets[i];
+            try
+            {
+                auto conn = db_pool_->get_connection();
+                pqxx::work trxn{*conn};
+                auto [filings, stored] =
+                    LoadShardSet(set_path, trxn, schema_prefix_ + "unified_extracts", replace_DB_content_);
+                trxn.commit();
+                MarkShardSetLoaded(set_path);
+
+                spdlog::info(catenate("Loaded shard set: ", set_path.string(), ". Filings: ", filings,
+                                      ". Stored: ", stored, "."));
+
+                std::lock_guard<std::mutex> lock(counters_mutex);
+                counters = AddTs(counters, std::tuple{stored, filings - stored, 0});
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::error(catenate("Problem loading shard set: ", set_path.string(), ". ", e.what()));
+
+                std::lock_guard<std::mutex> lock(counters_mutex);
+                ++std::get<2>(counters);
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> loaders;
+        for (int i = 0; i < load_threads; ++i)
+        {
+            loaders.emplace_back(load_sets);
+        }
+    }
+
+    return counters;
+} /* -----  end of method ExtractorApp::LoadShards  ----- */
 
 void ExtractorApp::HandleSignal(int signal)
 
@@ -41,6 +41,8 @@
 // #include <fstream>
 #include <atomic>
 #include <filesystem>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <tuple>
@@ -58,9 +60,15 @@ namespace fs = std::filesystem;
 
 #include <spdlog/spdlog.h>
 
-// #include "ExtractorMutexAndLock.h"
+#include "DatabasePool.h"
+#include "ExtractorMutexAndLock.h"
+#include "Extractor_HTML_FileFilter.h"
 #include "Extractor_Utils.h"
+#include "Extractor_XBRL_FileFilter.h"
+#include "FactExport.h"
+#include "FilingShards.h"
 #include "SharesOutstanding.h"
+#include "XBRL_InstanceReader.h"
 
 class ExtractorApp
 {
@@ -97,6 +105,31 @@ protected:
         e_XLS
     };
 
+    // what we pull out of a filing with XBRL data.
+
+    struct XBRL_Extracts
+    {
+        EM::FilingData filing_data_;
+        std::vector<EM::GAAP_Data> gaap_data_;
+        EM::Extractor_Labels label_data_;
+        EM::ContextPeriod context_data_;
+    };
+
+    // carries one filing from reading through extracting to storing.
+    // the header and document sections point into the mapped file so
+    // they all travel together.
+
+    struct FilingInProcess
+    {
+        EM::FileName file_name_;
+        MappedFile mapped_file_;
+        EM::SEC_Header_fields SEC_fields_;
+        EM::DocumentSectionList document_sections_;
+        EM::sv sec_header_;
+        FileMode file_mode_{FileMode::e_HTML};
+        std::variant<std::monostate, XBRL_Extracts, XLS_FinancialStatements, FinancialStatements> content_;
+    };
+
     //	Setup for parsing program options.
 
     void SetupProgramOptions();
@@ -109,20 +142,24 @@ protected:
 
     void BuildFilterList();
     void BuildListOfFilesToProcess();
+    void PrecheckListOfFiles();
+    bool ApplyHeaderFilters(const EM::SEC_Header_fields &SEC_fields, const EM::FileName &file_name);
     std::optional<FileMode> ApplyFilters(const EM::SEC_Header_fields &SEC_fields, const EM::FileName &file_name,
                                          const EM::DocumentSectionList &sections, std::atomic<int> *forms_processed);
 
-    bool LoadFileFromFolderToDB(const EM::FileName &file_name, const EM::SEC_Header_fields &SEC_fields,
-                                const EM::DocumentSectionList &sections, EM::sv sec_header, FileMode file_mode,
-                                std::mutex *db_mutex = nullptr);
-    bool LoadFileFromFolderToDB_XBRL(const EM::FileName &file_name, const EM::SEC_Header_fields &SEC_fields,
-                                     const EM::DocumentSectionList &sections, std::mutex *db_mutex = nullptr);
-    bool LoadFileFromFolderToDB_XLS(const EM::FileName &file_name, const EM::SEC_Header_fields &SEC_fields,
-                                    const EM::DocumentSectionList &sections, EM::sv sec_header,
-                                    std::mutex *db_mutex = nullptr);
-    bool LoadFileFromFolderToDB_HTML(const EM::FileName &file_name, const EM::SEC_Header_fields &SEC_fields,
-                                     const EM::DocumentSectionList &sections, EM::sv sec_header,
-                                     std::mutex *db_mutex = nullptr);
+    // the stages each file goes through when loading from a list or directory.
+
+    std::optional<FilingInProcess> ReadFiling(const EM::FileName &file_name, std::atomic<int> *forms_processed);
+    void ExtractFilingContent(FilingInProcess &filing);
+    bool StoreFilingContent(FilingInProcess &filing);
+    bool WriteFilingContent(FilingInProcess &filing, pqxx::dbtransaction &trxn);
+    bool WriteFilingShards(FilingInProcess &filing, ShardWriter &shard_writer);
+    bool WriteFilingFacts(FilingInProcess &filing, FactExporter &fact_exporter);
+    static size_t FilingRowCount(FilingInProcess &filing);
+    static std::string FilingLockID(const FilingInProcess &filing);
+
+    XBRL_InstanceData ReadInstanceDocument(EM::XBRLContent instance_document, const EM::FileName &file_name) const;
+
     bool ExportHtmlFromSingleFile(const EM::DocumentSectionList &sections, const EM::FileName &file_name,
                                   EM::sv sec_header);
     void Do_SingleFile(std::atomic<int> *forms_processed, int &success_counter, int &skipped_counter,
@@ -142,11 +179,11 @@ protected:
                                                       EM::sv sec_header, const EM::SEC_Header_fields &SEC_fields,
                                                       const EM::FileName &input_file_name);
     std::tuple<int, int, int> ProcessDirectory();
+    std::tuple<int, int, int> ProcessDirectoryConcurrently();
     std::tuple<int, int, int> LoadFilesFromListToDB();
     std::tuple<int, int, int> LoadFilesFromListToDBConcurrently();
-
-    std::tuple<int, int, int> LoadFileAsync(const EM::FileName &file_name, std::atomic<int> *forms_processed,
-                                            std::mutex *db_mutex);
+    std::tuple<int, int, int> LoadFilesConcurrently(const std::function<std::optional<EM::FileName>()> &next_file);
+    std::tuple<int, int, int> LoadShards();
 
     // ====================  DATA MEMBERS  =======================================
 
@@ -179,6 +216,7 @@ private:
     std::string data_source_{"BOTH"};
     std::string form_{"10-Q"};
     std::string DB_mode_{"test"};
+    std::string DB_connection_{"dbname=sec_extracts user=extractor_pg"};
     std::string schema_prefix_;
     std::string CIK_;
     std::string SIC_;
@@ -192,6 +230,16 @@ private:
 
     FilterList filters_;
 
+    // one connection per worker. created in CheckArgs once we know how many
+    // workers we will have.
+
+    std::unique_ptr<DatabasePool> db_pool_;
+
+    // what the DB already holds for the files in our list. lets the
+    // NeedToUpdateDBContent filter skip its per-file queries.
+
+    std::optional<PrecheckedFilings> prechecked_filings_;
+
     EM::FileName list_of_files_to_process_path_;
     EM::FileName log_file_path_name_;
     EM::FileName local_form_file_directory_;
@@ -199,6 +247,15 @@ private:
     EM::FileName SS_export_directory_;
     EM::FileName HTML_export_source_directory_;
     EM::FileName HTML_export_target_directory_;
+    EM::FileName output_shards_directory_;
+    EM::FileName load_shards_directory_;
+    EM::FileName export_facts_directory_;
+
+    // write shards or export facts for the single threaded paths. concurrent
+    // store workers each have their own.
+
+    std::unique_ptr<ShardWriter> shard_writer_;
+    std::unique_ptr<FactExporter> fact_exporter_;
 
     std::vector<EM::sv> list_of_files_to_process_;
 
@@ -206,8 +263,17 @@ private:
 
     int max_forms_to_process_{-1}; // mainly for testing
     int max_at_a_time_{-1};        // how many concurrent downloads allowed
+    int read_threads_{2};          // concurrent mode: threads reading and filtering files
+    int extract_threads_{0};       // concurrent mode: threads parsing content. 0 means 1 per core.
+    int batch_rows_{20000};        // concurrent mode: rows per DB commit
+    int batch_ms_{1000};           // concurrent mode: longest a filing waits for its commit
+    int shard_MB_{256};            // shard mode: size at which a worker starts a new shard set
+    int index_build_workers_{4};   // bulk mode: parallel maintenance workers for each index rebuild
 
     bool replace_DB_content_{false};
+    bool upsert_filing_ID_{false};
+    bool bulk_load_{false};
+    bool verify_instance_reader_{false};
     bool help_requested_{false};
     bool filename_has_form_{false};
     bool export_XLS_files_{false};
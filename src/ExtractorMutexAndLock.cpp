@@ -61,6 +61,11 @@ ExtractLock::ExtractLock(ExtractMutex *extract_list, const std::string &locking_
     }
 } // -----  end of method ExtractLock::ExtractLock  (constructor)  -----
 
+ExtractLock::ExtractLock(ExtractMutex *extract_list, const std::string &locking_id, std::try_to_lock_t)
+    : extract_list_{extract_list}, locking_id_{locking_id}, lock_is_active_{extract_list_->AddEntry(locking_id)}
+{
+} // -----  end of method ExtractLock::ExtractLock  (constructor)  -----
+
 ExtractLock::~ExtractLock()
 {
     if (lock_is_active_)
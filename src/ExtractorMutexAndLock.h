@@ -75,10 +75,17 @@ class ExtractLock
 public:
     // ====================  LIFECYCLE     =======================================
     ExtractLock(ExtractMutex *active_forms, const std::string &locking_id_); // constructor
+    ExtractLock(ExtractMutex *active_forms, const std::string &locking_id_,
+                std::try_to_lock_t); // don't wait if someone else has it
     ~ExtractLock(void);
 
     // ====================  ACCESSORS     =======================================
 
+    [[nodiscard]] bool owns_lock() const
+    {
+        return lock_is_active_;
+    }
+
     // ====================  MUTATORS      =======================================
 
     //    bool SeekExtractLock(const std::string& locking_id);
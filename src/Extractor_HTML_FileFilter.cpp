@@ -44,6 +44,8 @@
 #include <format>
 #include <ranges>
 
+#include "CopyTextWriter.h"
+#include "DatabasePool.h"
 #include "HTML_FromFile.h"
 #include "TablesFromFile.h"
 
@@ -934,7 +936,7 @@ MultDataList CreateMultiplierListWhenNoAnchors(const std::vector<EM::DocumentSec
     static const boost::regex table{R"***(<table)***", boost::regex_constants::normal | boost::regex_constants::icase};
 
     MultDataList results;
-    for (auto document : document_sections)
+    for (const auto &document : document_sections)
     {
         auto html = FindHTML(document, document_name);
         if (!html.get().empty())
@@ -1063,6 +1065,36 @@ bool StockholdersEquity::ValidateContent()
     return false;
 } /* -----  end of method StockholdersEquity::ValidateContent  ----- */
 
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  CollectFilingIDValues
+ *  Description:  the sec_filing_id fields for an HTML filing.
+ * =====================================================================================
+ */
+FilingIDValues CollectFilingIDValues(const EM::SEC_Header_fields &SEC_fields,
+                                     const FinancialStatements &financial_statements)
+{
+    const auto &form_type = SEC_fields.at("form_type");
+    EM::sv base_form_type{form_type};
+    if (base_form_type.ends_with("_A"))
+    {
+        base_form_type.remove_suffix(2);
+    }
+
+    return FilingIDValues{SEC_fields.at("cik"),
+                          SEC_fields.at("company_name"),
+                          SEC_fields.at("file_name"),
+                          std::nullopt,
+                          SEC_fields.at("sic"),
+                          std::string{base_form_type},
+                          SEC_fields.at("date_filed"),
+                          SEC_fields.at("quarter_ending"),
+                          std::nullopt,
+                          std::to_string(financial_statements.outstanding_shares_),
+                          "HTML",
+                          form_type.ends_with("_A")};
+} /* -----  end of function CollectFilingIDValues  ----- */
+
 /*
  * ===  FUNCTION
  * ====================================================================== Name:
@@ -1070,7 +1102,8 @@ bool StockholdersEquity::ValidateContent()
  * =====================================================================================
  */
 bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const FinancialStatements &financial_statements,
-                  const std::string &schema_name, bool replace_DB_content)
+                  pqxx::dbtransaction &trxn, const std::string &schema_name, bool replace_DB_content,
+                  bool upsert_filing_ID)
 {
     auto form_type = SEC_fields.at("form_type");
     EM::sv base_form_type{form_type};
@@ -1079,119 +1112,111 @@ bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const FinancialStatem
         base_form_type.remove_suffix(2);
     }
 
-    // start stuffing the database.
-    // we only get here if we are going to add/replace data.
-    // but now that we are doing amended forms too, there are
-    // some wrinkles
-    // there are even more 'wrinkles' when we are running async.
-    // we may have multiple files that map to the samie cik/form/period_end_date
-    // that get through the check for existing data but clash on the insert.  In
-    // fact, we want insert failures.
+    std::string filing_ID;
 
-    pqxx::connection c{"dbname=sec_extracts user=extractor_pg"};
-    pqxx::work trxn{c};
-
-    // when checking for existing data, we don't filter on source
-    // since that may have changed (especially if we are processing an
-    // amended form)
-
-    // NOTE: data_source is now part of the primary key so we DO need to
-    // include it in our check below.
-
-    auto save_original_data_cmd =
-        std::format("SELECT date_filed, file_name, amended_date_filed, "
-                    "amended_file_name FROM {3}.sec_filing_id WHERE"
-                    " cik = {0} AND form_type = {1} AND period_ending = {2} AND data_source = 'HTML'",
-                    trxn.quote(SEC_fields.at("cik")), trxn.quote(base_form_type),
-                    trxn.quote(SEC_fields.at("quarter_ending")), schema_name);
-
-    spdlog::debug("\n*** save original data cmd: {}\n", save_original_data_cmd);
-
-    auto saved_original_data = trxn.exec(save_original_data_cmd);
-
-    std::string original_date_filed;
-    std::string original_file_name;
-    std::string amended_date_filed;
-    std::string amended_file_name;
-
-    if (!saved_original_data.empty())
+    if (upsert_filing_ID)
     {
-        if (!saved_original_data[0]["date_filed"].is_null())
+        auto upserted =
+            UpsertFilingID(trxn, CollectFilingIDValues(SEC_fields, financial_statements), replace_DB_content);
+        if (!upserted)
         {
-            original_date_filed = saved_original_data[0]["date_filed"].view();
-        }
-        if (!saved_original_data[0]["file_name"].is_null())
-        {
-            original_file_name = saved_original_data[0]["file_name"].view();
+            return false;
         }
-        if (!saved_original_data[0]["amended_date_filed"].is_null())
+        filing_ID = std::move(*upserted);
+    }
+    else
+    {
+        // start stuffing the database.
+        // we only get here if we are going to add/replace data.
+        // but now that we are doing amended forms too, there are
+        // some wrinkles
+        // there are even more 'wrinkles' when we are running async.
+        // we may have multiple files that map to the samie cik/form/period_end_date
+        // that get through the check for existing data but clash on the insert.  In
+        // fact, we want insert failures.
+
+        // when checking for existing data, we don't filter on source
+        // since that may have changed (especially if we are processing an
+        // amended form)
+
+        // NOTE: data_source is now part of the primary key so we DO need to
+        // include it in our check below.
+
+        auto saved_original_data =
+            trxn.exec(pqxx::prepped{"filing_id_lookup_by_source"},
+                      pqxx::params{SEC_fields.at("cik"), base_form_type, SEC_fields.at("quarter_ending"), "HTML"});
+
+        std::string original_date_filed;
+        std::string original_file_name;
+        std::string amended_date_filed;
+        std::string amended_file_name;
+
+        if (!saved_original_data.empty())
         {
-            amended_date_filed = saved_original_data[0]["amended_date_filed"].view();
+            if (!saved_original_data[0]["date_filed"].is_null())
+            {
+                original_date_filed = saved_original_data[0]["date_filed"].view();
+            }
+            if (!saved_original_data[0]["file_name"].is_null())
+            {
+                original_file_name = saved_original_data[0]["file_name"].view();
+            }
+            if (!saved_original_data[0]["amended_date_filed"].is_null())
+            {
+                amended_date_filed = saved_original_data[0]["amended_date_filed"].view();
+            }
+            if (!saved_original_data[0]["amended_file_name"].is_null())
+            {
+                amended_file_name = saved_original_data[0]["amended_file_name"].view();
+            }
         }
-        if (!saved_original_data[0]["amended_file_name"].is_null())
+        else if (!form_type.ends_with("_A"))
         {
-            amended_file_name = saved_original_data[0]["amended_file_name"].view();
+            original_date_filed = SEC_fields.at("date_filed");
+            original_file_name = SEC_fields.at("file_name");
         }
-    }
-    else if (!form_type.ends_with("_A"))
-    {
-        original_date_filed = SEC_fields.at("date_filed");
-        original_file_name = SEC_fields.at("file_name");
-    }
-
-    auto date_filed = StringToDateYMD("%F", SEC_fields.at("date_filed"));
-    std::chrono::year_month_day date_filed_amended = 1900y / 1 / 1d; // need to start somewhere
 
-    if (!amended_date_filed.empty())
-    {
-        date_filed_amended = StringToDateYMD("%F", amended_date_filed);
-    }
+        auto date_filed = StringToDateYMD("%F", SEC_fields.at("date_filed"));
+        std::chrono::year_month_day date_filed_amended = 1900y / 1 / 1d; // need to start somewhere
 
-    if (!replace_DB_content && form_type.ends_with("_A") && date_filed <= date_filed_amended)
-    {
-        return false;
-    }
+        if (!amended_date_filed.empty())
+        {
+            date_filed_amended = StringToDateYMD("%F", amended_date_filed);
+        }
 
-    if (replace_DB_content || (form_type.ends_with("_A") && date_filed > date_filed_amended))
-    {
-        if (form_type.ends_with("_A"))
+        if (!replace_DB_content && form_type.ends_with("_A") && date_filed <= date_filed_amended)
         {
-            amended_date_filed = SEC_fields.at("date_filed");
-            amended_file_name = SEC_fields.at("file_name");
+            return false;
         }
 
-        auto delete_for_filing_ID_cmd = std::format("DELETE FROM {3}.sec_filing_id WHERE"
-                                                    " cik = {0} AND form_type = {1} AND period_ending = {2}",
-                                                    trxn.quote(SEC_fields.at("cik")), trxn.quote(base_form_type),
-                                                    trxn.quote(SEC_fields.at("quarter_ending")), schema_name);
+        if (replace_DB_content || (form_type.ends_with("_A") && date_filed > date_filed_amended))
+        {
+            if (form_type.ends_with("_A"))
+            {
+                amended_date_filed = SEC_fields.at("date_filed");
+                amended_file_name = SEC_fields.at("file_name");
+            }
 
-        spdlog::debug("\n*** delete data for filing ID cmd: {}\n", delete_for_filing_ID_cmd);
+            trxn.exec(pqxx::prepped{"filing_id_delete"},
+                      pqxx::params{SEC_fields.at("cik"), base_form_type, SEC_fields.at("quarter_ending")});
+        }
 
-        trxn.exec(delete_for_filing_ID_cmd);
+        filing_ID =
+            trxn.exec(pqxx::prepped{"filing_id_insert"},
+                      pqxx::params{SEC_fields.at("cik"), SEC_fields.at("company_name"), NullIfEmpty(original_file_name),
+                                   std::optional<std::string>{}, SEC_fields.at("sic"), base_form_type,
+                                   NullIfEmpty(original_date_filed), SEC_fields.at("quarter_ending"),
+                                   std::optional<std::string>{}, financial_statements.outstanding_shares_, "HTML",
+                                   NullIfEmpty(amended_file_name), NullIfEmpty(amended_date_filed)})
+                .one_field()
+                .as<std::string>();
     }
 
-    auto filing_ID_cmd = std::format(
-        "INSERT INTO {9}.sec_filing_id"
-        " (cik, company_name, file_name, symbol, sic, form_type, date_filed, "
-        "period_ending,"
-        " shares_outstanding, data_source, amended_file_name, amended_date_filed)"
-        " VALUES ({0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}, '{10}', {11}, "
-        "{12}) RETURNING filing_id",
-        trxn.quote(SEC_fields.at("cik")), trxn.quote(SEC_fields.at("company_name")),
-        original_file_name.empty() ? "NULL" : trxn.quote(original_file_name), "NULL", trxn.quote(SEC_fields.at("sic")),
-        trxn.quote(base_form_type), original_date_filed.empty() ? "NULL" : trxn.quote(original_date_filed),
-        trxn.quote(SEC_fields.at("quarter_ending")), financial_statements.outstanding_shares_, schema_name, "HTML",
-        amended_file_name.empty() ? "NULL" : trxn.quote(amended_file_name),
-        amended_date_filed.empty() ? "NULL" : trxn.quote(amended_date_filed));
-    // std::cout << filing_ID_cmd << '\n';
-    spdlog::debug("\n*** insert data for filing ID cmd: {}\n", filing_ID_cmd);
-    auto filing_ID = trxn.query_value<std::string>(filing_ID_cmd);
-
     // now, the goal of all this...save all the financial values for the given
     // time period.
 
     int counter = 0;
-    auto inserter1{pqxx::stream_to::table(trxn, {schema_name, "sec_bal_sheet_data"}, {"filing_id", "label", "value"})};
+    CopyTextWriter inserter1{trxn, {schema_name, "sec_bal_sheet_data"}, {"filing_id", "label", "value"}};
     //    pqxx::stream_to inserter1{trxn, schema_name + ".sec_bal_sheet_data",
     //        std::vector<std::string>{"filing_ID", "label", "value"}};
 
@@ -1199,13 +1224,12 @@ bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const FinancialStatem
     for (const auto &[label, value] : financial_statements.balance_sheet_.values_)
     {
         ++counter;
-        inserter1.write_values(filing_ID, label, value);
+        inserter1.WriteRow(filing_ID, label, value);
     }
 
-    inserter1.complete();
+    inserter1.Complete();
 
-    auto inserter2{
-        pqxx::stream_to::table(trxn, {schema_name, "sec_stmt_of_ops_data"}, {"filing_id", "label", "value"})};
+    CopyTextWriter inserter2{trxn, {schema_name, "sec_stmt_of_ops_data"}, {"filing_id", "label", "value"}};
     //    pqxx::stream_to inserter2{trxn, schema_name + ".sec_stmt_of_ops_data",
     //        std::vector<std::string>{"filing_ID", "label", "value"}};
 
@@ -1213,12 +1237,12 @@ bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const FinancialStatem
     for (const auto &[label, value] : financial_statements.statement_of_operations_.values_)
     {
         ++counter;
-        inserter2.write_values(filing_ID, label, value);
+        inserter2.WriteRow(filing_ID, label, value);
     }
 
-    inserter2.complete();
+    inserter2.Complete();
 
-    auto inserter3{pqxx::stream_to::table(trxn, {schema_name, "sec_cash_flows_data"}, {"filing_id", "label", "value"})};
+    CopyTextWriter inserter3{trxn, {schema_name, "sec_cash_flows_data"}, {"filing_id", "label", "value"}};
     //    pqxx::stream_to inserter3{trxn, schema_name + ".sec_cash_flows_data",
     //        std::vector<std::string>{"filing_ID", "label", "value"}};
 
@@ -1226,16 +1250,66 @@ bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const FinancialStatem
     for (const auto &[label, value] : financial_statements.cash_flows_.values_)
     {
         ++counter;
-        inserter3.write_values(filing_ID, label, value);
+        inserter3.WriteRow(filing_ID, label, value);
     }
 
-    inserter3.complete();
-
-    trxn.commit();
+    inserter3.Complete();
 
     return true;
 } /* -----  end of function LoadDataToDB  ----- */
 
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  WriteDataToShards
+ *  Description:
+ * =====================================================================================
+ */
+void WriteDataToShards(const EM::SEC_Header_fields &SEC_fields, const FinancialStatements &financial_statements,
+                       ShardWriter &shard_writer)
+{
+    shard_writer.AddFiling(CollectFilingIDValues(SEC_fields, financial_statements));
+
+    for (const auto &[label, value] : financial_statements.balance_sheet_.values_)
+    {
+        shard_writer.AddRow(ShardWriter::Table::e_bal_sheet_data, label, value);
+    }
+    for (const auto &[label, value] : financial_statements.statement_of_operations_.values_)
+    {
+        shard_writer.AddRow(ShardWriter::Table::e_stmt_of_ops_data, label, value);
+    }
+    for (const auto &[label, value] : financial_statements.cash_flows_.values_)
+    {
+        shard_writer.AddRow(ShardWriter::Table::e_cash_flows_data, label, value);
+    }
+} /* -----  end of function WriteDataToShards  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  ExportFacts
+ *  Description:
+ * =====================================================================================
+ */
+void ExportFacts(const EM::SEC_Header_fields &SEC_fields, const FinancialStatements &financial_statements,
+                 FactExporter &fact_exporter)
+{
+    fact_exporter.StartFiling(CollectFilingIDValues(SEC_fields, financial_statements));
+
+    for (const auto &[label, value] : financial_statements.balance_sheet_.values_)
+    {
+        fact_exporter.AddStatementFact("bal_sheet", label, value);
+    }
+    for (const auto &[label, value] : financial_statements.statement_of_operations_.values_)
+    {
+        fact_exporter.AddStatementFact("stmt_of_ops", label, value);
+    }
+    for (const auto &[label, value] : financial_statements.cash_flows_.values_)
+    {
+        fact_exporter.AddStatementFact("cash_flows", label, value);
+    }
+
+    fact_exporter.EndFiling();
+} /* -----  end of function ExportFacts  ----- */
+
 // ===  FUNCTION
 // ======================================================================
 //         Name:  UpdateOutstandingShares
@@ -1245,7 +1319,7 @@ bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const FinancialStatem
 
 int UpdateOutstandingShares(const SharesOutstanding &so, const EM::DocumentSectionList &document_sections,
                             const EM::SEC_Header_fields &fields, const std::vector<std::string> &forms,
-                            const std::string &schema_name, EM::FileName file_name)
+                            PooledConnection &conn, const std::string &schema_name, EM::FileName file_name)
 {
     int entries_updated{0};
 
@@ -1257,8 +1331,7 @@ int UpdateOutstandingShares(const SharesOutstanding &so, const EM::DocumentSecti
     {
         int64_t file_shares = so(financial_content->html_);
 
-        pqxx::connection cnxn{"dbname=sec_extracts user=extractor_pg"};
-        pqxx::work trxn{cnxn};
+        pqxx::work trxn{*conn};
 
         auto check_for_existing_content_cmd =
             std::format("SELECT count(*) FROM {3}.sec_filing_id WHERE"
@@ -47,6 +47,8 @@
 #include "AnchorsFromHTML.h"
 #include "Extractor.h"
 #include "Extractor_Utils.h"
+#include "FactExport.h"
+#include "FilingShards.h"
 #include "HTML_FromFile.h"
 #include "SharesOutstanding.h"
 #include "TablesFromFile.h"
@@ -302,11 +304,23 @@ MultDataList CreateMultiplierListWhenNoAnchors(const std::vector<EM::DocumentSec
 
 std::string ApplyMultiplierAndCleanUpValue(const EM::Extracted_Value &value, const std::string &multiplier);
 
+FilingIDValues CollectFilingIDValues(const EM::SEC_Header_fields &SEC_fields,
+                                     const FinancialStatements &financial_statements);
+
+// does not commit. see the XBRL version.
+
 bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const FinancialStatements &financial_statements,
-                  const std::string &schema_name, bool replace_DB_content);
+                  pqxx::dbtransaction &trxn, const std::string &schema_name, bool replace_DB_content,
+                  bool upsert_filing_ID);
+
+void WriteDataToShards(const EM::SEC_Header_fields &SEC_fields, const FinancialStatements &financial_statements,
+                       ShardWriter &shard_writer);
+
+void ExportFacts(const EM::SEC_Header_fields &SEC_fields, const FinancialStatements &financial_statements,
+                 FactExporter &fact_exporter);
 
 int UpdateOutstandingShares(const SharesOutstanding &so, const EM::DocumentSectionList &document_sections,
                             const EM::SEC_Header_fields &fields, const std::vector<std::string> &forms,
-                            const std::string &schema_name, EM::FileName file_name);
+                            PooledConnection &conn, const std::string &schema_name, EM::FileName file_name);
 
 #endif
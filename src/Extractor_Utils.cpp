@@ -33,15 +33,22 @@
 
 #include "Extractor_Utils.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/regex.hpp>
+#include <cerrno>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <ranges>
 #include <sstream>
 #include <stacktrace>
+#include <system_error>
 
 namespace rng = std::ranges;
 
@@ -53,7 +60,9 @@ namespace fs = std::filesystem;
 
 using namespace std::string_literals;
 
+#include "DatabasePool.h"
 #include "Extractor.h"
+#include "SectionScanner.h"
 
 std::chrono::year_month_day StringToDateYMD(const std::string &input_format, const std::string &the_date)
 {
@@ -165,56 +174,257 @@ std::string LoadDataFileForUse(const EM::FileName &file_name)
 } /* -----  end of function LoadDataFileForUse  ----- */
 
 /*
- * ===  FUNCTION
- * ====================================================================== Name:
- * LocateDocumentSections Description:
+ * ===  FUNCTION  ======================================================================
+ *         Name:  LoadSECHeaderForUse
+ *  Description:  the SEC header is at the front of the file and is usually only a few KB
+ *                long so read in small chunks until we find the end of it.
+ *                If there is no end tag, we return whatever we read and let the header
+ *                parser complain.
  * =====================================================================================
  */
-EM::DocumentSectionList LocateDocumentSections(EM::FileContent file_content)
+std::string LoadSECHeaderForUse(const EM::FileName &file_name)
 {
-    const std::string doc_begin{"<DOCUMENT>"};
-    const std::string doc_end{"</DOCUMENT>"};
-    const auto doc_begin_len = doc_begin.size();
-    const auto doc_end_len = doc_end.size();
-
-    EM::DocumentSectionList result;
+    static constexpr EM::sv header_end{"</SEC-HEADER>"};
+    static constexpr std::streamsize chunk_size{8192};
 
-    auto found_begin = file_content.get().begin();
-    auto content_end = file_content.get().end();
+    std::ifstream input_file{file_name.get(), std::ios_base::in | std::ios_base::binary};
+    if (!input_file)
+    {
+        throw std::system_error{errno, std::system_category(), catenate("Unable to open file: ", file_name.get())};
+    }
 
-    auto doc_searcher = std::boyer_moore_searcher(doc_end.begin(), doc_end.end());
+    std::string header_content;
+    size_t search_from{0};
 
-    while (found_begin != content_end)
+    while (input_file)
     {
-        // look for our begin tag
-
-        found_begin = std::search(found_begin, content_end, doc_begin.begin(), doc_begin.end());
+        const auto prior_size = header_content.size();
+        header_content.resize(prior_size + chunk_size);
+        input_file.read(&header_content[prior_size], chunk_size);
+        header_content.resize(prior_size + input_file.gcount());
 
-        if (found_begin == content_end)
+        if (auto pos = header_content.find(header_end, search_from); pos != std::string::npos)
         {
+            header_content.resize(pos + header_end.size());
             break;
         }
 
-        // now, look for our end tag.
-        // since this can be rather far away, try boyer-moore
+        // our end tag could straddle the chunk boundary.
+
+        search_from = header_content.size() < header_end.size() ? 0 : header_content.size() - header_end.size() + 1;
+    }
+
+    return header_content;
+} /* -----  end of function LoadSECHeaderForUse  ----- */
+
+/*
+ *--------------------------------------------------------------------------------------
+ *       Class:  MappedFile
+ *      Method:  MappedFile
+ * Description:  constructor
+ *--------------------------------------------------------------------------------------
+ */
+MappedFile::MappedFile(const EM::FileName &file_name)
+{
+    int fd = ::open(file_name.get().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::system_error{errno, std::system_category(), catenate("Unable to open file: ", file_name.get())};
+    }
+
+    struct stat file_info;
+    if (::fstat(fd, &file_info) != 0)
+    {
+        std::error_code err{errno, std::system_category()};
+        ::close(fd);
+        throw std::system_error{err, catenate("Unable to stat file: ", file_name.get())};
+    }
+
+    // mmap won't map an empty file so we just leave ourselves empty.
+
+    if (file_info.st_size == 0)
+    {
+        ::close(fd);
+        return;
+    }
+
+    void *mapping = ::mmap(nullptr, file_info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping keeps its own reference to the file so we are done with the descriptor.
+
+    std::error_code err{errno, std::system_category()};
+    ::close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        throw std::system_error{err, catenate("Unable to map file: ", file_name.get())};
+    }
+
+    // we (mostly) scan from front to back so tell the kernel to read ahead aggressively.
+    // this is just advice so we don't care if it fails.
+
+    ::madvise(mapping, file_info.st_size, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const char *>(mapping);
+    size_ = file_info.st_size;
+} /* -----  end of method MappedFile::MappedFile  (constructor)  ----- */
+
+MappedFile::MappedFile(MappedFile &&rhs) noexcept : data_{rhs.data_}, size_{rhs.size_}
+{
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+} /* -----  end of method MappedFile::MappedFile  (constructor)  ----- */
+
+MappedFile::~MappedFile()
+{
+    Unmap();
+} /* -----  end of method MappedFile::~MappedFile  (destructor)  ----- */
+
+MappedFile &MappedFile::operator=(MappedFile &&rhs) noexcept
+{
+    if (&rhs != this)
+    {
+        Unmap();
+        data_ = rhs.data_;
+        size_ = rhs.size_;
+        rhs.data_ = nullptr;
+        rhs.size_ = 0;
+    }
+    return *this;
+} /* -----  end of method MappedFile::operator=  ----- */
+
+void MappedFile::Unmap()
+{
+    if (data_ != nullptr)
+    {
+        ::munmap(const_cast<char *>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+} /* -----  end of method MappedFile::Unmap  ----- */
 
-        auto found_end = std::search(found_begin + doc_begin_len, content_end, doc_searcher);
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  TagLineValue
+ *  Description:  the rest of the line following a section header tag.
+ * =====================================================================================
+ */
+static EM::sv TagLineValue(EM::sv content, size_t value_begin)
+{
+    auto value = content.substr(value_begin, content.find('\n', value_begin) - value_begin);
+    if (auto last = value.find_last_not_of(" \t\r"); last != EM::sv::npos)
+    {
+        return value.substr(0, last + 1);
+    }
+    return {};
+} /* -----  end of function TagLineValue  ----- */
 
-        if (found_end == content_end)
+/*
+ * ===  FUNCTION
+ * ====================================================================== Name:
+ * LocateDocumentSections Description:  we make 1 pass over the content to find all
+ * the section markers then walk the markers to build our list of sections along
+ * with what we need to know about each.
+ * =====================================================================================
+ */
+EM::DocumentSectionList LocateDocumentSections(EM::FileContent file_content)
+{
+    const EM::sv content{file_content.get()};
+    const auto markers = FindSectionMarkers(content);
+
+    // the section header tags only count if they start a line.
+
+    auto at_line_start = [content](size_t offset) { return offset == 0 || content[offset - 1] == '\n'; };
+
+    EM::DocumentSectionList result;
+
+    EM::DocumentSection section;
+    size_t doc_begin{EM::sv::npos};
+    size_t text_begin{EM::sv::npos};
+    size_t text_end{EM::sv::npos};
+
+    for (const auto &[offset, length, marker] : markers)
+    {
+        if (doc_begin == EM::sv::npos)
         {
-            throw ExtractorException("Can't find end of 'DOCUMENT'");
+            if (marker == SectionMarker::e_DocumentBegin)
+            {
+                doc_begin = offset;
+                text_begin = EM::sv::npos;
+                text_end = EM::sv::npos;
+                section = {};
+            }
+            continue;
         }
 
-        // but we need to check for nested tags which should not happen.
-
-        //        if (*(found_end - 1) != '/' or *(found_end - 2) != '<')
-        //        {
-        //            throw ExtractorException("Looks like embedded 'DOCUMENT'
-        //            sections.");
-        //        }
+        switch (marker)
+        {
+            case SectionMarker::e_Type:
+                if (text_begin == EM::sv::npos && section.type_.empty() && at_line_start(offset))
+                {
+                    section.type_ = TagLineValue(content, offset + length);
+                }
+                break;
+
+            case SectionMarker::e_FileName:
+                if (text_begin == EM::sv::npos && section.file_name_.empty() && at_line_start(offset))
+                {
+                    section.file_name_ = TagLineValue(content, offset + length);
+                    if (auto dot = section.file_name_.rfind('.'); dot != EM::sv::npos)
+                    {
+                        section.extension_ = section.file_name_.substr(dot);
+                    }
+                }
+                break;
+
+            case SectionMarker::e_TextBegin:
+
+                // text begins with the newline ending the <TEXT> line.
+
+                if (text_begin == EM::sv::npos && at_line_start(offset))
+                {
+                    text_begin = std::min(content.find('\n', offset), content.size());
+                }
+                break;
+
+            case SectionMarker::e_TextEnd:
+                if (text_begin != EM::sv::npos && offset >= text_begin)
+                {
+                    text_end = offset;
+                }
+                break;
+
+            case SectionMarker::e_DocumentEnd:
+                section.content_ = content.substr(doc_begin, offset + length - doc_begin);
+                if (text_end != EM::sv::npos)
+                {
+                    section.text_ = content.substr(text_begin, text_end - text_begin);
+
+                    // the first thing in the text tells us how it's packaged.
+
+                    if (auto first = section.text_.find_first_not_of(" \t\r\n"); first != EM::sv::npos)
+                    {
+                        auto leading = section.text_.substr(first);
+                        section.has_XBRL_ = leading.starts_with("<XBRL>");
+                        section.is_uuencoded_ = leading.starts_with("begin ");
+                    }
+                }
+                result.push_back(section);
+                doc_begin = EM::sv::npos;
+                break;
+
+            case SectionMarker::e_DocumentBegin:
+
+                // nested documents should not happen. we just keep going
+                // until we find the end of the one we're in.
+
+                break;
+        }
+    }
 
-        result.emplace_back(EM::DocumentSection{EM::sv(found_begin, found_end + doc_end_len - found_begin)});
-        found_begin = found_end + doc_end_len;
+    if (doc_begin != EM::sv::npos)
+    {
+        throw ExtractorException("Can't find end of 'DOCUMENT'");
     }
     return result;
 } /* -----  end of function LocateDocumentSections  ----- */
@@ -227,14 +437,9 @@ EM::DocumentSectionList LocateDocumentSections(EM::FileContent file_content)
  */
 EM::FileName FindFileName(const EM::DocumentSection &document, const EM::FileName &document_name)
 {
-    const boost::regex regex_fname{R"***(^<FILENAME>(.*?)$)***"};
-    boost::cmatch matches;
-
-    if (bool found_it = boost::regex_search(document.get().cbegin(), document.get().cend(), matches, regex_fname);
-        found_it)
+    if (!document.file_name_.empty())
     {
-        EM::FileName file_name{std::string(matches[1].first, matches[1].length())};
-        return file_name;
+        return EM::FileName{fs::path{document.file_name_}};
     }
     throw ExtractorException(catenate("Can't find file name in document: ", document_name.get()));
 } /* -----  end of function FindFileName  ----- */
@@ -247,14 +452,9 @@ EM::FileName FindFileName(const EM::DocumentSection &document, const EM::FileNam
  */
 EM::FileType FindFileType(const EM::DocumentSection &document)
 {
-    const boost::regex regex_ftype{R"***(^<TYPE>(.*?)$)***"};
-    boost::cmatch matches;
-
-    if (bool found_it = boost::regex_search(document.get().cbegin(), document.get().cend(), matches, regex_ftype);
-        found_it)
+    if (!document.type_.empty())
     {
-        EM::FileType file_type{EM::sv(matches[1].first, matches[1].length())};
-        return file_type;
+        return EM::FileType{document.type_};
     }
     throw ExtractorException("Can't find file type in document.\n");
 } /* -----  end of function FindFileType  ----- */
@@ -268,27 +468,9 @@ EM::FileType FindFileType(const EM::DocumentSection &document)
 
 EM::HTMLContent FindHTML(const EM::DocumentSection &document, const EM::FileName &document_name)
 {
-    auto file_name = FindFileName(document, document_name);
-    if (file_name.get().extension() == ".htm")
+    if (document.extension_ == ".htm")
     {
-        // now, we just need to drop the extraneous XML surrounding the data we
-        // need.
-
-        auto result{document.get()};
-        auto text_begin_loc = result.find(R"***(<TEXT>)***");
-
-        // skip 1 more line.
-
-        text_begin_loc = result.find('\n', text_begin_loc + 1);
-
-        result.remove_prefix(text_begin_loc);
-
-        auto text_end_loc = result.rfind(R"***(</TEXT>)***");
-        if (text_end_loc != EM::sv::npos)
-        {
-            result.remove_suffix(result.length() - text_end_loc);
-        }
-        else
+        if (document.text_.empty())
         {
             throw HTMLException("Can't find end of HTML in document.\n");
         }
@@ -296,26 +478,12 @@ EM::HTMLContent FindHTML(const EM::DocumentSection &document, const EM::FileName
         // sometimes the document is actually XBRL with embedded HTML
         // we don't want that.
 
-        if (result.find(R"***(<XBRL>)***") != EM::sv::npos)
+        if (document.has_XBRL_)
         {
-            //            // let's see if it contains HTML
-            //
-            //            const boost::regex regex_meta{R"***(<meta.*?</meta>)***"};
-            //            boost::cmatch matches;
-            //
-            //            if (boost::regex_search(result.begin(), result.end(),
-            //            matches, regex_meta))
-            //            {
-            //                EM::sv meta(result.data() + matches.position(),
-            //                matches.length()); if (meta.find("text/html"))
-            //                {
-            //                    return result;
-            //                }
-            //            }
             spdlog::debug("File: {}. Looks like HTML is really XBRL.", document_name);
             return EM::HTMLContent{};
         }
-        return EM::HTMLContent{result};
+        return EM::HTMLContent{document.text_};
     }
     return EM::HTMLContent{};
 } /* -----  end of function FindHTML  ----- */
@@ -334,17 +502,9 @@ bool FileHasXBRL::operator()(const EM::SEC_Header_fields &SEC_fields,
 {
     // need to do a little more detailed check.
 
-    EM::FileName document_name(SEC_fields.at("file_name"));
-    for (const auto &document : document_sections)
-    {
-        auto file_name = FindFileName(document, document_name);
-        auto file_type = FindFileType(document);
-        if (file_type.get().ends_with(".INS") && file_name.get().extension() == ".xml")
-        {
-            return true;
-        }
-    }
-    return false;
+    return rng::any_of(document_sections, [](const auto &document) {
+        return document.type_.ends_with(".INS") && document.extension_ == ".xml";
+    });
 } /* -----  end of method FileHasXBRL::operator()  ----- */
 
 bool FileHasXLS::operator()(const EM::SEC_Header_fields &SEC_fields,
@@ -352,16 +512,7 @@ bool FileHasXLS::operator()(const EM::SEC_Header_fields &SEC_fields,
 {
     // need to do a little more detailed check.
 
-    EM::FileName document_name(SEC_fields.at("file_name"));
-    for (const auto &document : document_sections)
-    {
-        auto file_name = FindFileName(document, document_name);
-        if (file_name.get().extension() == ".xlsx")
-        {
-            return true;
-        }
-    }
-    return false;
+    return rng::any_of(document_sections, [](const auto &document) { return document.extension_ == ".xlsx"; });
 } /* -----  end of method FileHasXBRL::operator()  ----- */
 
 /*
@@ -376,21 +527,9 @@ bool FileHasHTML::operator()(const EM::SEC_Header_fields &header_fields,
     // need to do a little more detailed check.
 
     EM::FileName document_name(header_fields.at("file_name"));
-    for (const auto &document : document_sections)
-    {
-        auto file_name = FindFileName(document, document_name);
-        auto file_type = FindFileType(document);
-
-        if (file_name.get().extension() == ".htm")
-        {
-            auto content = FindHTML(document, file_name);
-            if (!content.get().empty())
-            {
-                return true;
-            }
-        }
-    }
-    return false;
+    return rng::any_of(document_sections, [&document_name](const auto &document) {
+        return !FindHTML(document, document_name).get().empty();
+    });
 } /* -----  end of function FileHasHTML::operator()  ----- */
 
 bool FileHasFormType::operator()(const EM::SEC_Header_fields &SEC_fields,
@@ -431,34 +570,59 @@ bool NeedToUpdateDBContent::operator()(const EM::SEC_Header_fields &SEC_fields,
         base_form_type.remove_suffix(2);
     }
 
-    pqxx::connection c{"dbname=sec_extracts user=extractor_pg"};
-    pqxx::work trxn{c};
+    std::string have_data{"(0 rows)"};
+    std::string amended_date;
 
-    std::string check_for_existing_content_cmd;
-    if (mode_ == "BOTH")
+    const std::optional<ExistingFiling> *prechecked{nullptr};
+    if (prechecked_ != nullptr)
     {
-        // check_for_existing_content_cmd =
-        //     std::format("SELECT count(*) AS how_many FROM {3}unified_extracts.sec_filing_id "
-        check_for_existing_content_cmd = std::format("SELECT file_name FROM {3}unified_extracts.sec_filing_id "
-                                                     "WHERE"
-                                                     " cik = {0} AND form_type = {1} AND period_ending = {2}",
-                                                     trxn.quote(SEC_fields.at("cik")), trxn.quote(base_form_type),
-                                                     trxn.quote(SEC_fields.at("quarter_ending")), schema_prefix_);
+        auto found = prechecked_->find(FilingKey(SEC_fields));
+        if (found != prechecked_->end())
+        {
+            prechecked = &found->second;
+        }
     }
-    else
+
+    if (prechecked != nullptr)
     {
-        check_for_existing_content_cmd =
-            std::format("SELECT file_name FROM {3}unified_extracts.sec_filing_id "
-                        "WHERE"
-                        " cik = {0} AND form_type = {1} AND period_ending = {2} AND "
-                        "data_source = {4}",
-                        trxn.quote(SEC_fields.at("cik")), trxn.quote(base_form_type),
-                        trxn.quote(SEC_fields.at("quarter_ending")), schema_prefix_, trxn.quote(mode_));
+        if (prechecked->has_value())
+        {
+            have_data = (*prechecked)->file_name_;
+            amended_date = (*prechecked)->amended_date_filed_;
+        }
     }
+    else
+    {
+        // these are just lookups so skip the BEGIN/COMMIT round trips.
 
-    auto have_data =
-        trxn.query_value<std::string>(catenate("SELECT COALESCE((", check_for_existing_content_cmd, "), '(0 rows)')"));
-    trxn.commit();
+        auto conn = db_pool_->get_connection();
+        pqxx::nontransaction trxn{*conn};
+
+        pqxx::params filing_key{SEC_fields.at("cik"), base_form_type, SEC_fields.at("quarter_ending")};
+
+        // mode BOTH doesn't care where existing data came from.
+
+        if (mode_ != "BOTH")
+        {
+            filing_key.append(mode_);
+        }
+        have_data =
+            trxn.exec(pqxx::prepped{mode_ == "BOTH" ? "filing_id_existing" : "filing_id_existing_by_source"},
+                      filing_key)
+                .one_field()
+                .as<std::string>();
+
+        if (have_data != "(0 rows)" && !replace_DB_content_ && form_type.ends_with("_A"))
+        {
+            auto row = trxn.exec(pqxx::prepped{"filing_id_amended_date"},
+                                 pqxx::params{SEC_fields.at("cik"), base_form_type, SEC_fields.at("quarter_ending")})
+                           .one_row();
+            if (!row["amended_date_filed"].is_null())
+            {
+                amended_date = row["amended_date_filed"].view();
+            }
+        }
+    }
 
     if (have_data != "(0 rows)" && !replace_DB_content_ && !form_type.ends_with("_A"))
     {
@@ -476,20 +640,6 @@ bool NeedToUpdateDBContent::operator()(const EM::SEC_Header_fields &SEC_fields,
 
     if (have_data != "(0 rows)" && !replace_DB_content_ && form_type.ends_with("_A"))
     {
-        check_for_existing_content_cmd =
-            std::format("SELECT amended_date_filed FROM {3}unified_extracts.sec_filing_id WHERE"
-                        " cik = {0} AND form_type = {1} AND period_ending = {2}",
-                        trxn.quote(SEC_fields.at("cik")), trxn.quote(base_form_type),
-                        trxn.quote(SEC_fields.at("quarter_ending")), schema_prefix_);
-
-        pqxx::work trxn{c};
-        auto row = trxn.exec(check_for_existing_content_cmd).one_row();
-        std::string amended_date;
-        if (!row["amended_date_filed"].is_null())
-        {
-            amended_date = row["amended_date_filed"].view();
-        }
-        trxn.commit();
         if (amended_date.empty())
         {
             // no previously stored ameended data so
@@ -510,6 +660,267 @@ bool NeedToUpdateDBContent::operator()(const EM::SEC_Header_fields &SEC_fields,
     return true;
 } /* -----  end of method NeedToUpdateDBContent::operator()  ----- */
 
+std::string FilingKey(EM::sv cik, EM::sv base_form_type, EM::sv period_ending)
+{
+    return catenate(cik, '|', base_form_type, '|', period_ending);
+} /* -----  end of function FilingKey  ----- */
+
+std::string FilingKey(const EM::SEC_Header_fields &SEC_fields)
+{
+    return FilingKey(SEC_fields, SEC_fields.at("quarter_ending"));
+} /* -----  end of function FilingKey  ----- */
+
+std::string FilingKey(const EM::SEC_Header_fields &SEC_fields, EM::sv period_ending)
+{
+    EM::sv base_form_type{SEC_fields.at("form_type")};
+    if (base_form_type.ends_with("_A"))
+    {
+        base_form_type.remove_suffix(2);
+    }
+    return FilingKey(SEC_fields.at("cik"), base_form_type, period_ending);
+} /* -----  end of function FilingKey  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  FindExistingFilings
+ *  Description:  gives the same answers as the per-file queries in NeedToUpdateDBContent,
+ *                including treating a row without a file_name as not there.
+ * =====================================================================================
+ */
+PrecheckedFilings FindExistingFilings(DatabasePool *db_pool, const std::string &schema_prefix,
+                                      const std::string &mode, const std::vector<FilingKeyFields> &candidates)
+{
+    PrecheckedFilings prechecked;
+    prechecked.reserve(candidates.size());
+
+    auto conn = db_pool->get_connection();
+    pqxx::work trxn{*conn};
+
+    trxn.exec("CREATE TEMP TABLE candidate_filings (cik TEXT, form_type TEXT, period_ending DATE) ON COMMIT DROP");
+
+    auto inserter{pqxx::stream_to::table(trxn, {"candidate_filings"}, {"cik", "form_type", "period_ending"})};
+    for (const auto &candidate : candidates)
+    {
+        inserter.write_row(candidate);
+        const auto &[cik, form_type, period_ending] = candidate;
+        prechecked.emplace(FilingKey(cik, form_type, period_ending), std::nullopt);
+    }
+    inserter.complete();
+
+    auto find_existing_cmd = std::format(
+        "SELECT c.cik, c.form_type, c.period_ending::TEXT, e.file_name,"
+        " (SELECT MAX(a.amended_date_filed)::TEXT FROM {0}unified_extracts.sec_filing_id a"
+        " WHERE a.cik = c.cik AND a.form_type = c.form_type AND a.period_ending = c.period_ending)"
+        " FROM candidate_filings c"
+        " JOIN LATERAL (SELECT f.file_name FROM {0}unified_extracts.sec_filing_id f"
+        " WHERE f.cik = c.cik AND f.form_type = c.form_type AND f.period_ending = c.period_ending"
+        " AND ({1} = 'BOTH' OR f.data_source = {1}) LIMIT 1) e ON e.file_name IS NOT NULL",
+        schema_prefix, trxn.quote(mode));
+
+    for (const auto &[cik, form_type, period_ending, file_name, amended_date_filed] :
+         trxn.query<std::string, std::string, std::string, std::string, std::optional<std::string>>(
+             find_existing_cmd))
+    {
+        prechecked[FilingKey(cik, form_type, period_ending)] =
+            ExistingFiling{file_name, amended_date_filed.value_or("")};
+    }
+    trxn.commit();
+
+    return prechecked;
+} /* -----  end of function FindExistingFilings  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  PrepareFilingIDStatements
+ *  Description:  register the sec_filing_id statements on a new connection.
+ *                the schema name is baked into the statement text so these
+ *                are good for 1 schema per connection.
+ * =====================================================================================
+ */
+void PrepareFilingIDStatements(pqxx::connection &conn, const std::string &schema_name)
+{
+    conn.prepare("filing_id_lookup",
+                 std::format("SELECT date_filed, file_name, amended_date_filed, amended_file_name"
+                             " FROM {0}.sec_filing_id WHERE cik = $1 AND form_type = $2 AND period_ending = $3",
+                             schema_name));
+
+    conn.prepare("filing_id_lookup_by_source",
+                 std::format("SELECT date_filed, file_name, amended_date_filed, amended_file_name"
+                             " FROM {0}.sec_filing_id WHERE cik = $1 AND form_type = $2 AND period_ending = $3"
+                             " AND data_source = $4",
+                             schema_name));
+
+    conn.prepare("filing_id_delete",
+                 std::format("DELETE FROM {0}.sec_filing_id WHERE cik = $1 AND form_type = $2 AND period_ending = $3",
+                             schema_name));
+
+    // $1 cik, $2 company_name, $3 file_name, $4 symbol, $5 sic, $6 form_type, $7 date_filed,
+    // $8 period_ending, $9 period_context_id, $10 shares_outstanding, $11 data_source,
+    // $12 amended_file_name, $13 amended_date_filed
+
+    conn.prepare("filing_id_insert",
+                 std::format("INSERT INTO {0}.sec_filing_id"
+                             " (cik, company_name, file_name, symbol, sic, form_type, date_filed, period_ending,"
+                             " period_context_id, shares_outstanding, data_source, amended_file_name,"
+                             " amended_date_filed)"
+                             " VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13) RETURNING filing_id",
+                             schema_name));
+
+    conn.prepare("filing_id_existing",
+                 std::format("SELECT COALESCE((SELECT file_name FROM {0}.sec_filing_id"
+                             " WHERE cik = $1 AND form_type = $2 AND period_ending = $3), '(0 rows)')",
+                             schema_name));
+
+    conn.prepare("filing_id_existing_by_source",
+                 std::format("SELECT COALESCE((SELECT file_name FROM {0}.sec_filing_id"
+                             " WHERE cik = $1 AND form_type = $2 AND period_ending = $3 AND data_source = $4),"
+                             " '(0 rows)')",
+                             schema_name));
+
+    conn.prepare("filing_id_amended_date",
+                 std::format("SELECT amended_date_filed FROM {0}.sec_filing_id"
+                             " WHERE cik = $1 AND form_type = $2 AND period_ending = $3",
+                             schema_name));
+
+    // the same rules as the LoadDataToDB functions: an original form keeps
+    // its file name and date in file_name/date_filed, an amended form in
+    // amended_file_name/amended_date_filed. an existing row is only changed
+    // when replacing or when this is a later amendment.
+    // the data tables are cleared for an updated row. a new row has nothing
+    // to clear. rows from other data sources go the way they would with the
+    // delete.
+
+    // $1 cik, $2 company_name, $3 file_name, $4 symbol, $5 sic, $6 form_type, $7 date_filed,
+    // $8 period_ending, $9 period_context_id, $10 shares_outstanding, $11 data_source,
+    // $12 is_amended, $13 replace_DB_content
+
+    conn.prepare(
+        "filing_id_upsert",
+        std::format(
+            "WITH upserted AS ("
+            " INSERT INTO {0}.sec_filing_id AS existing"
+            " (cik, company_name, file_name, symbol, sic, form_type, date_filed, period_ending, period_context_id,"
+            " shares_outstanding, data_source, amended_file_name, amended_date_filed)"
+            " VALUES ($1, $2, CASE WHEN $12::BOOLEAN THEN NULL ELSE $3::TEXT END, $4, $5, $6,"
+            " CASE WHEN $12::BOOLEAN THEN NULL ELSE $7::DATE END, $8::DATE, $9, $10, $11,"
+            " CASE WHEN $12::BOOLEAN THEN $3::TEXT END, CASE WHEN $12::BOOLEAN THEN $7::DATE END)"
+            " ON CONFLICT (cik, form_type, period_ending, data_source) DO UPDATE SET"
+            " company_name = EXCLUDED.company_name, symbol = EXCLUDED.symbol, sic = EXCLUDED.sic,"
+            " period_context_id = EXCLUDED.period_context_id, shares_outstanding = EXCLUDED.shares_outstanding,"
+            " amended_file_name = CASE WHEN $12::BOOLEAN THEN EXCLUDED.amended_file_name"
+            " ELSE existing.amended_file_name END,"
+            " amended_date_filed = CASE WHEN $12::BOOLEAN THEN EXCLUDED.amended_date_filed"
+            " ELSE existing.amended_date_filed END"
+            " WHERE $13::BOOLEAN OR ($12::BOOLEAN AND"
+            " EXCLUDED.amended_date_filed > COALESCE(existing.amended_date_filed, DATE '1900-01-01'))"
+            " RETURNING filing_id),"
+            " other_sources AS (DELETE FROM {0}.sec_filing_id"
+            " WHERE cik = $1 AND form_type = $6 AND period_ending = $8::DATE AND data_source <> $11"
+            " AND ($12::BOOLEAN OR $13::BOOLEAN) AND EXISTS (SELECT 1 FROM upserted)),"
+            " bal_sheet AS (DELETE FROM {0}.sec_bal_sheet_data WHERE filing_id IN (SELECT filing_id FROM upserted)),"
+            " stmt_of_ops AS (DELETE FROM {0}.sec_stmt_of_ops_data"
+            " WHERE filing_id IN (SELECT filing_id FROM upserted)),"
+            " cash_flows AS (DELETE FROM {0}.sec_cash_flows_data"
+            " WHERE filing_id IN (SELECT filing_id FROM upserted)),"
+            " xbrl AS (DELETE FROM {0}.sec_xbrl_data WHERE filing_id IN (SELECT filing_id FROM upserted))"
+            " SELECT filing_id FROM upserted",
+            schema_name));
+} /* -----  end of function PrepareFilingIDStatements  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  UpsertFilingID
+ *  Description:  a non-amended form which finds an existing row and is not
+ *                replacing is skipped rather than failing on the insert.
+ * =====================================================================================
+ */
+std::optional<std::string> UpsertFilingID(pqxx::dbtransaction &trxn, const FilingIDValues &values,
+                                          bool replace_DB_content)
+{
+    auto upserted =
+        trxn.exec(pqxx::prepped{"filing_id_upsert"},
+                  pqxx::params{values.cik_, values.company_name_, values.file_name_, values.symbol_, values.sic_,
+                               values.form_type_, values.date_filed_, values.period_ending_,
+                               values.period_context_ID_, values.shares_outstanding_, values.data_source_,
+                               values.is_amended_, replace_DB_content});
+    if (upserted.empty())
+    {
+        return std::nullopt;
+    }
+    return upserted[0][0].as<std::string>();
+} /* -----  end of function UpsertFilingID  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  DeferDataTableIndexes
+ *  Description:  unique indexes and the single column filing_id indexes are kept.
+ *                everything else on the data tables is deferred.
+ * =====================================================================================
+ */
+int DeferDataTableIndexes(pqxx::connection &conn, const std::string &schema_name)
+{
+    pqxx::work trxn{conn};
+
+    trxn.exec(std::format("CREATE TABLE IF NOT EXISTS {0}.deferred_indexes"
+                          " (index_name TEXT PRIMARY KEY, index_def TEXT NOT NULL)",
+                          schema_name));
+
+    auto find_indexes_cmd = std::format(
+        "SELECT ic.relname, pg_get_indexdef(ix.indexrelid) FROM pg_index ix"
+        " JOIN pg_class ic ON ic.oid = ix.indexrelid"
+        " JOIN pg_class t ON t.oid = ix.indrelid"
+        " JOIN pg_namespace n ON n.oid = t.relnamespace"
+        " WHERE n.nspname = {0}"
+        " AND t.relname IN ('sec_bal_sheet_data', 'sec_stmt_of_ops_data', 'sec_cash_flows_data', 'sec_xbrl_data')"
+        " AND NOT ix.indisunique"
+        " AND NOT (ix.indnkeyatts = 1 AND ix.indkey[0] ="
+        " (SELECT a.attnum FROM pg_attribute a WHERE a.attrelid = t.oid AND a.attname = 'filing_id'))",
+        trxn.quote(schema_name));
+    auto indexes = trxn.exec(find_indexes_cmd);
+
+    for (const auto &index : indexes)
+    {
+        const auto index_name = index[0].as<std::string>();
+        trxn.exec(std::format("INSERT INTO {0}.deferred_indexes (index_name, index_def) VALUES ({1}, {2})",
+                              schema_name, trxn.quote(index_name), trxn.quote(index[1].as<std::string>())));
+        trxn.exec(std::format("DROP INDEX {0}.{1}", schema_name, trxn.quote_name(index_name)));
+        spdlog::info(catenate("Deferred index: ", index_name));
+    }
+
+    auto waiting = trxn.query_value<int>(std::format("SELECT count(*) FROM {0}.deferred_indexes", schema_name));
+    trxn.commit();
+
+    return waiting;
+} /* -----  end of function DeferDataTableIndexes  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  RebuildDeferredIndexes
+ *  Description:  builds them all in 1 transaction so they show up together or
+ *                not at all. a failure leaves them deferred.
+ * =====================================================================================
+ */
+int RebuildDeferredIndexes(pqxx::connection &conn, const std::string &schema_name, int parallel_workers)
+{
+    pqxx::work trxn{conn};
+
+    trxn.exec(std::format("CREATE TABLE IF NOT EXISTS {0}.deferred_indexes"
+                          " (index_name TEXT PRIMARY KEY, index_def TEXT NOT NULL)",
+                          schema_name));
+    trxn.exec(std::format("SET LOCAL max_parallel_maintenance_workers = {}", parallel_workers));
+
+    auto indexes = trxn.exec(std::format("SELECT index_name, index_def FROM {0}.deferred_indexes", schema_name));
+    for (const auto &index : indexes)
+    {
+        spdlog::info(catenate("Rebuilding index: ", index[0].view()));
+        trxn.exec(index[1].as<std::string>());
+    }
+    trxn.exec(std::format("DELETE FROM {0}.deferred_indexes", schema_name));
+    trxn.commit();
+
+    return indexes.size();
+} /* -----  end of function RebuildDeferredIndexes  ----- */
+
 bool FileIsWithinDateRange::operator()(const EM::SEC_Header_fields &SEC_fields,
                                        const EM::DocumentSectionList &document_sections) const
 {
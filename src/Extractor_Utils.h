@@ -39,10 +39,12 @@
 #include <filesystem>
 #include <format>
 #include <fstream>
+#include <optional>
 #include <ranges>
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -50,6 +52,15 @@
 
 namespace fs = std::filesystem;
 
+class DatabasePool;
+class PooledConnection;
+
+namespace pqxx
+{
+class connection;
+class dbtransaction;
+} // namespace pqxx
+
 using namespace std::string_literals;
 
 // some code to help with putting together error messages,
@@ -142,6 +153,70 @@ std::chrono::year_month_day StringToDateYMD(const std::string &input_format, con
 
 std::string LoadDataFileForUse(const EM::FileName &file_name);
 
+// reads just the leading portion of a file, up to and including the '</SEC-HEADER>' tag,
+// so we can decide whether we want the file before we load all of it.
+
+std::string LoadSECHeaderForUse(const EM::FileName &file_name);
+
+// =====================================================================================
+//        Class:  MappedFile
+//  Description:  read-only memory mapping of a data file.
+//
+//  Filings with embedded XBRL and XLSX content can be hundreds of MB so,
+//  rather than copy them onto the heap, we map them and let all downstream
+//  string_views point directly into the page cache.
+//  NOTE: the mapped content is NOT null terminated.
+// =====================================================================================
+
+class MappedFile
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    MappedFile() = default;
+    explicit MappedFile(const EM::FileName &file_name);
+
+    MappedFile(const MappedFile &rhs) = delete;
+    MappedFile(MappedFile &&rhs) noexcept;
+
+    ~MappedFile();
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] EM::FileContent GetContent() const
+    {
+        return EM::FileContent{EM::sv{data_, size_}};
+    }
+    [[nodiscard]] EM::sv GetView() const
+    {
+        return EM::sv{data_, size_};
+    }
+    [[nodiscard]] size_t size() const
+    {
+        return size_;
+    }
+    [[nodiscard]] bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    // ====================  OPERATORS     =======================================
+
+    MappedFile &operator=(const MappedFile &rhs) = delete;
+    MappedFile &operator=(MappedFile &&rhs) noexcept;
+
+private:
+    // ====================  METHODS       =======================================
+
+    void Unmap();
+
+    // ====================  DATA MEMBERS  =======================================
+
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+
+}; // -----  end of class MappedFile  -----
+
 // so we can recognize our errors if we want to do something special
 // now that we have both XBRL and HTML based extractors, we need
 // a more elaborate exception setup.
@@ -330,10 +405,47 @@ struct FileHasSIC
     const std::vector<std::string> SIC_list_;
 };
 
+// what the DB already had for a filing key when a file list was pre-checked.
+// file_name_ is the same value the per-file check would show as the prior source.
+
+struct ExistingFiling
+{
+    std::string file_name_;
+    std::string amended_date_filed_;
+};
+
+// every key which was checked maps to what was found, if anything. keys which
+// were not checked, are left to the DB.
+
+using PrecheckedFilings = std::unordered_map<std::string, std::optional<ExistingFiling>>;
+
+// cik, base form type, period ending
+
+using FilingKeyFields = std::tuple<std::string, std::string, std::string>;
+
+std::string FilingKey(EM::sv cik, EM::sv base_form_type, EM::sv period_ending);
+
+// same key from a filing's header: the form type without any '_A' and the
+// header's quarter ending unless some other period ending is given.
+
+std::string FilingKey(const EM::SEC_Header_fields &SEC_fields);
+std::string FilingKey(const EM::SEC_Header_fields &SEC_fields, EM::sv period_ending);
+
+// COPYs the candidate keys into a temp table and finds those already in sec_filing_id
+// with 1 query.
+
+PrecheckedFilings FindExistingFilings(DatabasePool *db_pool, const std::string &schema_prefix,
+                                      const std::string &mode, const std::vector<FilingKeyFields> &candidates);
+
 struct NeedToUpdateDBContent
 {
-    NeedToUpdateDBContent(const std::string &schema_prefix, const std::string &mode, bool replace_DB_content)
-        : schema_prefix_{schema_prefix}, mode_{mode}, replace_DB_content_{replace_DB_content}
+    NeedToUpdateDBContent(DatabasePool *db_pool, const std::string &schema_prefix, const std::string &mode,
+                          bool replace_DB_content, const PrecheckedFilings *prechecked = nullptr)
+        : db_pool_{db_pool},
+          schema_prefix_{schema_prefix},
+          mode_{mode},
+          replace_DB_content_{replace_DB_content},
+          prechecked_{prechecked}
     {
     }
 
@@ -341,11 +453,78 @@ struct NeedToUpdateDBContent
 
     const std::string filter_name_{"NeedToUpdateDBContent"};
 
+    DatabasePool *db_pool_;
     const std::string schema_prefix_;
     const std::string mode_;
     bool replace_DB_content_;
+    const PrecheckedFilings *prechecked_; // if set, answers for keys it covers without going to the DB
 };
 
+// every filing we load hits the sec_filing_id table several times so its
+// statements are prepared once on each DB connection. the names are:
+//
+//  filing_id_lookup            ($1 cik, $2 form_type, $3 period_ending)
+//  filing_id_lookup_by_source  (same plus $4 data_source)
+//  filing_id_delete            ($1 cik, $2 form_type, $3 period_ending)
+//  filing_id_insert            ($1 - $13, see PrepareFilingIDStatements)
+//  filing_id_existing          ($1 cik, $2 form_type, $3 period_ending)
+//  filing_id_existing_by_source (same plus $4 data_source)
+//  filing_id_amended_date      ($1 cik, $2 form_type, $3 period_ending)
+//  filing_id_upsert            (see UpsertFilingID)
+
+void PrepareFilingIDStatements(pqxx::connection &conn, const std::string &schema_name);
+
+// what we know about a filing when adding it to sec_filing_id.
+// form_type_ is the base form type, without any '_A'.
+
+struct FilingIDValues
+{
+    std::string cik_;
+    std::string company_name_;
+    std::string file_name_;
+    std::optional<std::string> symbol_;
+    std::string sic_;
+    std::string form_type_;
+    std::string date_filed_;
+    std::string period_ending_;
+    std::optional<std::string> period_context_ID_;
+    std::string shares_outstanding_;
+    std::string data_source_;
+    bool is_amended_{false};
+};
+
+// 1 round trip alternative to the lookup/delete/insert sequence in the
+// LoadDataToDB functions. An existing row for the same data source is
+// updated in place and its old data rows removed rather than the row being
+// deleted and re-inserted.
+// returns the filing_id to store data under or nothing if the existing
+// row should be left alone.
+
+std::optional<std::string> UpsertFilingID(pqxx::dbtransaction &trxn, const FilingIDValues &values,
+                                          bool replace_DB_content);
+
+// bulk loading. the text search and other query-only indexes on the data tables
+// are dropped before the load and built again after. their definitions are kept in
+// the deferred_indexes table so a run which doesn't finish leaves them for the next
+// one to rebuild. the filing_id indexes stay since deleting a filing's data
+// (replacing, amended forms, ON DELETE CASCADE) would scan the whole table without them.
+// both return how many indexes were waiting to be rebuilt.
+
+int DeferDataTableIndexes(pqxx::connection &conn, const std::string &schema_name);
+
+int RebuildDeferredIndexes(pqxx::connection &conn, const std::string &schema_name, int parallel_workers);
+
+// NULL parameter for an empty value.
+
+inline std::optional<std::string> NullIfEmpty(const std::string &value)
+{
+    if (value.empty())
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
 struct FileIsWithinDateRange
 {
     FileIsWithinDateRange(const std::chrono::year_month_day &begin_date, const std::chrono::year_month_day &end_date)
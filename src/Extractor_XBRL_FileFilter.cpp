@@ -45,13 +45,16 @@
 #include <iterator> // For std::back_inserter
 #include <ranges>   // For std::ranges and views
 
+#include "CopyTextWriter.h"
+#include "DatabasePool.h"
 #include "Extractor_Utils.h"
+#include "UUDecode.h"
 
 namespace rng = std::ranges; // Alias std::ranges to rng
 
-#include <pstreams/pstream.h>
 #include <spdlog/spdlog.h>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/regex.hpp>
 #include <pqxx/pqxx>
 #include <pqxx/transaction.hxx>
@@ -72,8 +75,11 @@ decltype(auto) MONTH_NAMES = std::array{"",     "January", "February",  "March",
 
 const std::string::size_type START_WITH{1000000};
 
-const boost::regex regex_value{
-    R"***(^([()"'A-Za-z ,.-]+)[^\t]*\t(?:\[[^\t]+?\]\t)?\$? *([(-]? *?[.,0-9]+[)]?)[^\t]*\t)***"};
+// XLS rows are matched a cell at a time: a label at the start of the first cell
+// and a number at the start of the next (or the one after a footnote like '[1]').
+
+const boost::regex regex_xls_label{R"***([()"'A-Za-z ,.-]+)***"};
+const boost::regex regex_xls_value{R"***(\$? *([(-]? *?[.,0-9]+[)]?))***"};
 const boost::regex regex_per_share{R"***(per.*?share)***",
                                    boost::regex_constants::normal | boost::regex_constants::icase};
 const boost::regex regex_dollar_mults{R"***([(][^)]*?in (thousands|millions|billions|dollars).*?[)])***",
@@ -85,13 +91,9 @@ const boost::regex regex_dollar_mults{R"***([(][^)]*?in (thousands|millions|bill
 const std::string &FindOrDefault(const EM::Extractor_Labels &labels, const std::string &key,
                                  const std::string &default_result)
 {
-    if (labels.contains(key))
+    if (auto found = labels.find(key); found != labels.end() && !found->second.empty())
     {
-        decltype(auto) val = labels.at(key);
-        if (!val.empty())
-        {
-            return labels.at(key);
-        }
+        return found->second;
     }
     return default_result;
 }
@@ -103,11 +105,20 @@ const std::string &FindOrDefault(const EM::Extractor_Labels &labels, const std::
 XLS_FinancialStatements FindAndExtractXLSContent(EM::DocumentSectionList const &document_sections,
                                                  const EM::FileName &document_name)
 {
-    static const boost::regex regex_finance_statements_bal{R"***(balance\s+sheet|financial position)***"};
-    static const boost::regex regex_finance_statements_ops{
+    static const std::string bal_pattern{R"***(balance\s+sheet|financial position)***"};
+    static const std::string ops_pattern{
         R"***((?:(?:statement|statements)\s+?of.*?(?:oper|loss|income|earning|expense))|(?:income|loss|earning statement))***"};
-    static const boost::regex regex_finance_statements_cash{
-        R"***(((?:ment|ments)\s+?of.*?(?:cash\s*flow))|cash flows? state)***"};
+    static const std::string cash_pattern{R"***(((?:ment|ments)\s+?of.*?(?:cash\s*flow))|cash flows? state)***"};
+
+    static const boost::regex regex_finance_statements_bal{bal_pattern};
+    static const boost::regex regex_finance_statements_ops{ops_pattern};
+    static const boost::regex regex_finance_statements_cash{cash_pattern};
+
+    // most sheets are notes and details. 1 search against all 3 patterns
+    // lets us skip those without trying each pattern in turn.
+
+    static const boost::regex regex_finance_statements_any{
+        catenate("(?:", bal_pattern, ")|(?:", ops_pattern, ")|(?:", cash_pattern, ")")};
 
     XLS_FinancialStatements financial_statements;
 
@@ -118,31 +129,49 @@ XLS_FinancialStatements FindAndExtractXLSContent(EM::DocumentSectionList const &
 
     financial_statements.outstanding_shares_ = ExtractXLSSharesOutstanding(*xls_file.begin());
 
-    auto bal_sheets = rng::find_if(xls_file, [](const auto &x) {
-        const auto &name = x.GetSheetNameFromInside();
-        return boost::regex_search(name, regex_finance_statements_bal);
-    });
-    if (bal_sheets != rng::end(xls_file))
+    // 1 pass over the sheets, keeping the first sheet which matches each statement.
+    // a title can match more than 1 statement so check each one we still need.
+
+    std::optional<XLS_Sheet> bal_sheet;
+    std::optional<XLS_Sheet> stmt_of_ops;
+    std::optional<XLS_Sheet> cash_flows;
+
+    for (const auto &sheet : xls_file)
     {
-        financial_statements.balance_sheet_.found_sheet_ = true;
-        financial_statements.balance_sheet_.values_ = CollectXLSValues(*bal_sheets);
+        const auto &name = sheet.GetSheetNameFromInside();
+        if (!boost::regex_search(name, regex_finance_statements_any))
+        {
+            continue;
+        }
+        if (!bal_sheet && boost::regex_search(name, regex_finance_statements_bal))
+        {
+            bal_sheet = sheet;
+        }
+        if (!stmt_of_ops && boost::regex_search(name, regex_finance_statements_ops))
+        {
+            stmt_of_ops = sheet;
+        }
+        if (!cash_flows && boost::regex_search(name, regex_finance_statements_cash))
+        {
+            cash_flows = sheet;
+        }
+        if (bal_sheet && stmt_of_ops && cash_flows)
+        {
+            break;
+        }
     }
 
-    auto stmt_of_ops = rng::find_if(xls_file, [](const auto &x) {
-        const auto &name = x.GetSheetNameFromInside();
-        return boost::regex_search(name, regex_finance_statements_ops);
-    });
-    if (stmt_of_ops != rng::end(xls_file))
+    if (bal_sheet)
+    {
+        financial_statements.balance_sheet_.found_sheet_ = true;
+        financial_statements.balance_sheet_.values_ = CollectXLSValues(*bal_sheet);
+    }
+    if (stmt_of_ops)
     {
         financial_statements.statement_of_operations_.found_sheet_ = true;
         financial_statements.statement_of_operations_.values_ = CollectXLSValues(*stmt_of_ops);
     }
-
-    auto cash_flows = rng::find_if(xls_file, [](const auto &x) {
-        const auto &name = x.GetSheetNameFromInside();
-        return boost::regex_search(name, regex_finance_statements_cash);
-    });
-    if (cash_flows != rng::end(xls_file))
+    if (cash_flows)
     {
         financial_statements.cash_flows_.found_sheet_ = true;
         financial_statements.cash_flows_.values_ = CollectXLSValues(*cash_flows);
@@ -171,37 +200,36 @@ EM::XLS_Values ExtractXLSFilingData(const XLS_Sheet &sheet)
 // =====================================================================================
 int64_t ExtractXLSSharesOutstanding(const XLS_Sheet &xls_sheet)
 {
-    const std::string nbr_of_shares = R"***(\t(\b[1-9](?:[0-9.]{2,})\b)\t)***";
-    const boost::regex::flag_type my_flags = {boost::regex_constants::normal | boost::regex_constants::icase};
-    const boost::regex regex_share_extractor{nbr_of_shares, my_flags};
+    // a whole cell, other than the label, holding just the number.
+
+    static const boost::regex regex_share_extractor{R"***([1-9][0-9.]+[0-9])***"};
 
     std::string shares = "-1";
 
     auto row_itor = xls_sheet.begin();
     int multiplier_skips = 1;
-    auto multiplier = ExtractMultiplier(*row_itor);
+    auto multiplier = ExtractMultiplier(row_itor->Text());
     if (multiplier.first.empty())
     {
-        multiplier = ExtractMultiplier(*(++row_itor));
+        multiplier = ExtractMultiplier((++row_itor)->Text());
         if (!multiplier.first.empty())
         {
             multiplier_skips = 2;
         }
     }
 
-    for (auto row : xls_sheet | rng::views::drop(multiplier_skips))
+    for (const auto &row : xls_sheet | rng::views::drop(multiplier_skips))
     {
-        rng::transform(row, row.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-
-        if (row.find("outstanding") == std::string::npos)
+        if (rng::none_of(row, [](EM::sv cell) { return boost::algorithm::icontains(cell, "outstanding"); }))
         {
             continue;
         }
-        boost::smatch the_shares;
-
-        if (bool found_it = boost::regex_search(row, the_shares, regex_share_extractor); found_it)
+        auto the_shares = rng::find_if(row | rng::views::drop(1), [](EM::sv cell) {
+            return boost::regex_match(cell.begin(), cell.end(), regex_share_extractor);
+        });
+        if (the_shares != rng::end(row))
         {
-            shares = the_shares.str(1);
+            shares = *the_shares;
         }
     }
 
@@ -260,10 +288,10 @@ EM::XLS_Values CollectXLSValues(const XLS_Sheet &sheet)
 
     auto row_itor = sheet.begin();
     int multiplier_skips = 1;
-    auto multiplier = ExtractMultiplier(*row_itor);
+    auto multiplier = ExtractMultiplier(row_itor->Text());
     if (multiplier.first.empty())
     {
-        multiplier = ExtractMultiplier(*(++row_itor));
+        multiplier = ExtractMultiplier((++row_itor)->Text());
         if (!multiplier.first.empty())
         {
             multiplier_skips = 2;
@@ -272,16 +300,26 @@ EM::XLS_Values CollectXLSValues(const XLS_Sheet &sheet)
 
     const std::string digits{"0123456789"};
 
+    auto match_cell = [](EM::sv cell, boost::cmatch &match_values, const boost::regex &regex) {
+        return boost::regex_search(cell.data(), cell.data() + cell.size(), match_values, regex,
+                                   boost::match_continuous);
+    };
+    auto is_footnote = [](EM::sv cell) { return cell.size() > 2 && cell.front() == '[' && cell.back() == ']'; };
+
     EM::XLS_Values values;
     for (const auto &a_row : sheet | rng::views::drop(multiplier_skips))
     {
-        boost::smatch match_values;
-        if (boost::regex_search(a_row.cbegin(), a_row.cend(), match_values, regex_value))
+        boost::cmatch label;
+        if (a_row.size() < 2 || !match_cell(a_row[0], label, regex_xls_label))
         {
-            if (rng::any_of(match_values[2].str(), [&digits](char c) { return digits.find(c) != std::string::npos; }))
-            {
-                values.emplace_back(match_values[1].str(), match_values[2].str());
-            }
+            continue;
+        }
+        boost::cmatch value;
+        bool found_value = (a_row.size() > 2 && is_footnote(a_row[1]) && match_cell(a_row[2], value, regex_xls_value))
+                           || match_cell(a_row[1], value, regex_xls_value);
+        if (found_value && rng::any_of(value.str(1), [&digits](char c) { return digits.find(c) != std::string::npos; }))
+        {
+            values.emplace_back(label.str(), value.str(1));
         }
     }
 
@@ -383,30 +421,18 @@ std::pair<std::string, int64_t> ExtractMultiplier(std::string row)
 EM::XBRLContent LocateInstanceDocument(const EM::DocumentSectionList &document_sections,
                                        const EM::FileName &document_name)
 {
-    for (const auto &document : document_sections)
-    {
-        auto file_name = FindFileName(document, document_name);
-        auto file_type = FindFileType(document);
-        if (file_type.get().ends_with(".INS") && file_name.get().extension() == ".xml")
-        {
-            return TrimExcessXML(document);
-        }
-    }
-    return EM::XBRLContent{};
+    auto document = rng::find_if(document_sections, [](const auto &section) {
+        return section.type_.ends_with(".INS") && section.extension_ == ".xml";
+    });
+    return document != rng::end(document_sections) ? TrimExcessXML(*document) : EM::XBRLContent{};
 }
 
 EM::XBRLContent LocateLabelDocument(const EM::DocumentSectionList &document_sections, const EM::FileName &document_name)
 {
-    for (const auto &document : document_sections)
-    {
-        auto file_name = FindFileName(document, document_name);
-        auto file_type = FindFileType(document);
-        if (file_type.get().ends_with(".LAB") && file_name.get().extension() == ".xml")
-        {
-            return TrimExcessXML(document);
-        }
-    }
-    return EM::XBRLContent{};
+    auto document = rng::find_if(document_sections, [](const auto &section) {
+        return section.type_.ends_with(".LAB") && section.extension_ == ".xml";
+    });
+    return document != rng::end(document_sections) ? TrimExcessXML(*document) : EM::XBRLContent{};
 }
 
 // ===  FUNCTION  ======================================================================
@@ -415,36 +441,18 @@ EM::XBRLContent LocateLabelDocument(const EM::DocumentSectionList &document_sect
 // =====================================================================================
 EM::XLSContent LocateXLSDocument(const EM::DocumentSectionList &document_sections, const EM::FileName &document_name)
 {
-    for (const auto &document : document_sections)
-    {
-        auto file_name = FindFileName(document, document_name);
-        if (file_name.get().extension() == ".xlsx")
-        {
-            auto doc = document.get();
-
-            // now, we just need to drop the extraneous XML surrounding the data we need.
-            // which is a little different from what we do for the other document types.
-
-            auto x = doc.find(R"***(<TEXT>)***");
-            // skip 1 more lines.
-
-            x = doc.find('\n', x + 1);
+    // the text of the section is the uuencoded spreadsheet.
 
-            doc.remove_prefix(x);
-
-            auto ss_end_loc = doc.rfind(R"***(</TEXT>)***");
-            if (ss_end_loc != EM::sv::npos)
-            {
-                doc.remove_suffix(doc.length() - ss_end_loc);
-            }
-            else
-            {
-                throw std::runtime_error("Can't find end of spread sheet in document.\n");
-            }
-            return EM::XLSContent{doc};
-        }
+    auto document = rng::find_if(document_sections, [](const auto &section) { return section.extension_ == ".xlsx"; });
+    if (document == rng::end(document_sections))
+    {
+        return {};
     }
-    return {};
+    if (document->text_.empty())
+    {
+        throw std::runtime_error("Can't find end of spread sheet in document.\n");
+    }
+    return EM::XLSContent{document->text_};
 } // -----  end of function LocateXLSDocument  -----
 
 EM::FilingData ExtractFilingData(const pugi::xml_document &instance_xml)
@@ -471,101 +479,9 @@ EM::FilingData ExtractFilingData(const pugi::xml_document &instance_xml)
 // =====================================================================================
 std::vector<char> ExtractXLSData(EM::XLSContent xls_content)
 {
-    // we write our XLS file to the std::in of the decoder
-    // and read the decoder's std::out into a charater vector.
-    // No temp files involved.
-
-    redi::pstream out_in("uudecode -o /dev/stdout ",
-                         redi::pstreams::pstdin | redi::pstreams::pstdout | redi::pstreams::pstderr);
-    BOOST_ASSERT_MSG(out_in.is_open(), "Failed to open subprocess.");
-
-    // we use a buffer and the readsome function so that we will get any
-    // embedded return characters (which would be stripped off if we did
-    // readline.
+    // decode straight from the file content. no subprocess, no temp files.
 
-    std::array<char, 4096> buf{'\0'};
-    std::streamsize bytes_read;
-
-    std::vector<char> result;
-    std::string error_msg;
-
-    // it seems it's possible to have uuencoded data with 'short' lines
-    // so, we need to be sure each line is 61 bytes long.
-
-    auto lines = split_string<EM::sv>(xls_content.get(), "\n");
-    for (auto line : lines)
-    {
-        out_in.write(line.data(), line.size());
-        if (line == "end")
-        {
-            out_in.put('\n');
-            break;
-        }
-        for (int i = line.size(); i < 61; ++i)
-        {
-            out_in.put(' ');
-        }
-        out_in.put('\n');
-
-        // for short files, we can write all the lines
-        // and then go read the conversion output.
-        // BUT for longer files, we may need to read
-        // output along the way to avoid deadlocks...
-        // write won't complete until conversion output
-        // is read.
-
-        do
-        {
-            bytes_read = out_in.out().readsome(buf.data(), buf.max_size());
-            result.insert(result.end(), buf.data(), buf.data() + bytes_read);
-        } while (bytes_read != 0);
-
-        do
-        {
-            bytes_read = out_in.err().readsome(buf.data(), buf.max_size());
-            error_msg.append(buf.data(), bytes_read);
-        } while (bytes_read != 0);
-    }
-    //	write eod marker
-
-    out_in << redi::peof;
-
-    bool finished[2] = {false, false};
-
-    while (!finished[0] || !finished[1])
-    {
-        if (!finished[1])
-        {
-            while ((bytes_read = out_in.out().readsome(buf.data(), buf.max_size())) > 0)
-            {
-                result.insert(result.end(), buf.data(), buf.data() + bytes_read);
-            }
-            if (out_in.eof())
-            {
-                finished[1] = true;
-                if (!finished[0])
-                    out_in.clear();
-            }
-        }
-        if (!finished[0])
-        {
-            while ((bytes_read = out_in.err().readsome(buf.data(), buf.max_size())) > 0)
-            {
-                error_msg.append(buf.data(), bytes_read);
-            }
-            if (out_in.eof())
-            {
-                finished[0] = true;
-                if (!finished[1])
-                    out_in.clear();
-            }
-        }
-    }
-
-    auto return_code = out_in.close();
-
-    BOOST_ASSERT_MSG(return_code == 0, catenate("Problem decoding file: ", error_msg).c_str());
-    return result;
+    return UUDecode(xls_content.get());
 } // -----  end of function ExtractXLSData  -----
 
 std::string ConvertPeriodEndDateToContextName(EM::sv period_end_date)
@@ -860,9 +776,13 @@ EM::ContextPeriod ExtractContextDefinitions(const pugi::xml_document &instance_x
     return result;
 }
 
-EM::XBRLContent TrimExcessXML(EM::DocumentSection document)
+EM::XBRLContent TrimExcessXML(const EM::DocumentSection &document)
 {
-    auto doc_val = document.get();
+    if (!document.has_XBRL_)
+    {
+        throw XBRLException("Can't find XBLR in document.\n");
+    }
+    auto doc_val = document.text_;
     auto xbrl_loc = doc_val.find(R"***(<XBRL>)***");
     doc_val.remove_prefix(xbrl_loc + XBLR_TAG_LEN);
 
@@ -889,6 +809,65 @@ pugi::xml_document ParseXMLContent(EM::XBRLContent document)
     return doc;
 }
 
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  CollectFilingIDValues
+ *  Description:  the sec_filing_id fields for an XBRL filing.
+ * =====================================================================================
+ */
+FilingIDValues CollectFilingIDValues(const EM::SEC_Header_fields &SEC_fields, const EM::FilingData &filing_fields)
+{
+    const auto &form_type = SEC_fields.at("form_type");
+    EM::sv base_form_type{form_type};
+    if (base_form_type.ends_with("_A"))
+    {
+        base_form_type.remove_suffix(2);
+    }
+
+    return FilingIDValues{SEC_fields.at("cik"),
+                          SEC_fields.at("company_name"),
+                          SEC_fields.at("file_name"),
+                          NullIfEmpty(filing_fields.trading_symbol),
+                          SEC_fields.at("sic"),
+                          std::string{base_form_type},
+                          SEC_fields.at("date_filed"),
+                          filing_fields.period_end_date,
+                          filing_fields.period_context_ID,
+                          filing_fields.shares_outstanding,
+                          "XBRL",
+                          form_type.ends_with("_A")};
+} /* -----  end of function CollectFilingIDValues  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  CollectFilingIDValues
+ *  Description:  the sec_filing_id fields for a filing we only have the XLS for.
+ * =====================================================================================
+ */
+FilingIDValues CollectFilingIDValues(const EM::SEC_Header_fields &SEC_fields,
+                                     const XLS_FinancialStatements &financial_statements)
+{
+    const auto &form_type = SEC_fields.at("form_type");
+    EM::sv base_form_type{form_type};
+    if (base_form_type.ends_with("_A"))
+    {
+        base_form_type.remove_suffix(2);
+    }
+
+    return FilingIDValues{SEC_fields.at("cik"),
+                          SEC_fields.at("company_name"),
+                          SEC_fields.at("file_name"),
+                          std::nullopt,
+                          SEC_fields.at("sic"),
+                          std::string{base_form_type},
+                          SEC_fields.at("date_filed"),
+                          SEC_fields.at("quarter_ending"),
+                          std::nullopt,
+                          std::to_string(financial_statements.outstanding_shares_),
+                          "XLS",
+                          form_type.ends_with("_A")};
+} /* -----  end of function CollectFilingIDValues  ----- */
+
 /*
  * ===  FUNCTION  ======================================================================
  *         Name:  LoadDataToDB
@@ -897,7 +876,8 @@ pugi::xml_document ParseXMLContent(EM::XBRLContent document)
  */
 bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const EM::FilingData &filing_fields,
                   const std::vector<EM::GAAP_Data> &gaap_fields, const EM::Extractor_Labels &label_fields,
-                  const EM::ContextPeriod &context_fields, const std::string &schema_name, bool replace_DB_content)
+                  const EM::ContextPeriod &context_fields, pqxx::dbtransaction &trxn, const std::string &schema_name,
+                  bool replace_DB_content, bool upsert_filing_ID)
 {
     auto form_type = SEC_fields.at("form_type");
     EM::sv base_form_type{form_type};
@@ -906,121 +886,125 @@ bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const EM::FilingData
         base_form_type.remove_suffix(2);
     }
 
-    // start stuffing the database.
-    // we only get here if we are going to add/replace data.
-    // but now that we are doing amended forms too, there are
-    // some wrinkles
-    // there are even more 'wrinkles' when we are running async.
-    // we may have multiple files that map to the samie cik/form/period_end_date that get through the
-    // check for existing data but clash on the insert.  In fact, we want insert failures.
-
-    pqxx::connection c{"dbname=sec_extracts user=extractor_pg"};
-    pqxx::work trxn{c};
-
-    // when checking for existing data, we don't filter on source
-    // since that may have changed (especially if we are processing an
-    // amended form)
-
-    // NOTE: data_source is now part of the primary key so we DO need to
-    // include it in our check below.
-
-    auto save_original_data_cmd =
-        std::format("SELECT date_filed, file_name, amended_date_filed, amended_file_name FROM {3}.sec_filing_id WHERE"
-                    " cik = {0} AND form_type = {1} AND period_ending = {2} AND data_source = 'XBRL'",
-                    trxn.quote(SEC_fields.at("cik")), trxn.quote(base_form_type),
-                    trxn.quote(filing_fields.period_end_date), schema_name);
-    auto saved_original_data = trxn.exec(save_original_data_cmd);
-
-    std::string original_date_filed;
-    std::string original_file_name;
-    std::string amended_date_filed;
-    std::string amended_file_name;
-
-    if (!saved_original_data.empty())
+    std::string filing_ID;
+
+    if (upsert_filing_ID)
     {
-        if (!saved_original_data[0]["date_filed"].is_null())
+        auto upserted = UpsertFilingID(trxn, CollectFilingIDValues(SEC_fields, filing_fields), replace_DB_content);
+        if (!upserted)
         {
-            original_date_filed = saved_original_data[0]["date_filed"].view();
+            return false;
         }
-        if (!saved_original_data[0]["file_name"].is_null())
-        {
-            original_file_name = saved_original_data[0]["file_name"].view();
-        }
-        if (!saved_original_data[0]["amended_date_filed"].is_null())
+        filing_ID = std::move(*upserted);
+    }
+    else
+    {
+        // start stuffing the database.
+        // we only get here if we are going to add/replace data.
+        // but now that we are doing amended forms too, there are
+        // some wrinkles
+        // there are even more 'wrinkles' when we are running async.
+        // we may have multiple files that map to the samie cik/form/period_end_date that get through the
+        // check for existing data but clash on the insert.  In fact, we want insert failures.
+
+        // when checking for existing data, we don't filter on source
+        // since that may have changed (especially if we are processing an
+        // amended form)
+
+        // NOTE: data_source is now part of the primary key so we DO need to
+        // include it in our check below.
+
+        // the sec_filing_id statements are prepared on each connection. see PrepareFilingIDStatements.
+
+        auto saved_original_data =
+            trxn.exec(pqxx::prepped{"filing_id_lookup_by_source"},
+                      pqxx::params{SEC_fields.at("cik"), base_form_type, filing_fields.period_end_date, "XBRL"});
+
+        std::string original_date_filed;
+        std::string original_file_name;
+        std::string amended_date_filed;
+        std::string amended_file_name;
+
+        if (!saved_original_data.empty())
         {
-            amended_date_filed = saved_original_data[0]["amended_date_filed"].view();
+            if (!saved_original_data[0]["date_filed"].is_null())
+            {
+                original_date_filed = saved_original_data[0]["date_filed"].view();
+            }
+            if (!saved_original_data[0]["file_name"].is_null())
+            {
+                original_file_name = saved_original_data[0]["file_name"].view();
+            }
+            if (!saved_original_data[0]["amended_date_filed"].is_null())
+            {
+                amended_date_filed = saved_original_data[0]["amended_date_filed"].view();
+            }
+            if (!saved_original_data[0]["amended_file_name"].is_null())
+            {
+                amended_file_name = saved_original_data[0]["amended_file_name"].view();
+            }
         }
-        if (!saved_original_data[0]["amended_file_name"].is_null())
+        else if (!form_type.ends_with("_A"))
         {
-            amended_file_name = saved_original_data[0]["amended_file_name"].view();
+            original_date_filed = SEC_fields.at("date_filed");
+            original_file_name = SEC_fields.at("file_name");
         }
-    }
-    else if (!form_type.ends_with("_A"))
-    {
-        original_date_filed = SEC_fields.at("date_filed");
-        original_file_name = SEC_fields.at("file_name");
-    }
 
-    auto date_filed = StringToDateYMD("%F", SEC_fields.at("date_filed"));
-    std::chrono::year_month_day date_filed_amended = 1900y / 1 / 1d; // need to start somewhere
+        auto date_filed = StringToDateYMD("%F", SEC_fields.at("date_filed"));
+        std::chrono::year_month_day date_filed_amended = 1900y / 1 / 1d; // need to start somewhere
 
-    if (!amended_date_filed.empty())
-    {
-        date_filed_amended = StringToDateYMD("%F", amended_date_filed);
-    }
+        if (!amended_date_filed.empty())
+        {
+            date_filed_amended = StringToDateYMD("%F", amended_date_filed);
+        }
 
-    if (!replace_DB_content && form_type.ends_with("_A") && date_filed <= date_filed_amended)
-    {
-        return false;
-    }
+        if (!replace_DB_content && form_type.ends_with("_A") && date_filed <= date_filed_amended)
+        {
+            return false;
+        }
 
-    if (replace_DB_content || form_type.ends_with("_A") && date_filed > date_filed_amended)
-    {
-        if (form_type.ends_with("_A"))
+        if (replace_DB_content || form_type.ends_with("_A") && date_filed > date_filed_amended)
         {
-            amended_date_filed = SEC_fields.at("date_filed");
-            amended_file_name = SEC_fields.at("file_name");
+            if (form_type.ends_with("_A"))
+            {
+                amended_date_filed = SEC_fields.at("date_filed");
+                amended_file_name = SEC_fields.at("file_name");
+            }
+
+            trxn.exec(pqxx::prepped{"filing_id_delete"},
+                      pqxx::params{SEC_fields.at("cik"), base_form_type, SEC_fields.at("quarter_ending")});
         }
 
-        auto filing_ID_cmd = std::format("DELETE FROM {3}.sec_filing_id WHERE"
-                                         " cik = {0} AND form_type = {1} AND period_ending = {2}",
-                                         trxn.quote(SEC_fields.at("cik")), trxn.quote(base_form_type),
-                                         trxn.quote(SEC_fields.at("quarter_ending")), schema_name);
-        trxn.exec(filing_ID_cmd);
+        filing_ID =
+            trxn.exec(pqxx::prepped{"filing_id_insert"},
+                      pqxx::params{SEC_fields.at("cik"), SEC_fields.at("company_name"), NullIfEmpty(original_file_name),
+                                   NullIfEmpty(filing_fields.trading_symbol), SEC_fields.at("sic"), base_form_type,
+                                   NullIfEmpty(original_date_filed), filing_fields.period_end_date,
+                                   filing_fields.period_context_ID, filing_fields.shares_outstanding, "XBRL",
+                                   NullIfEmpty(amended_file_name), NullIfEmpty(amended_date_filed)})
+                .one_field()
+                .as<std::string>();
     }
 
-    auto filing_ID_cmd = std::format(
-        "INSERT INTO {11}.sec_filing_id"
-        " (cik, company_name, file_name, symbol, sic, form_type, date_filed, period_ending, period_context_id,"
-        " shares_outstanding, data_source, amended_file_name, amended_date_filed)"
-        " VALUES ({0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}, {9}, '{10}', {12}, {13}) RETURNING filing_id",
-        trxn.quote(SEC_fields.at("cik")), trxn.quote(SEC_fields.at("company_name")),
-        original_file_name.empty() ? "NULL" : trxn.quote(original_file_name),
-        filing_fields.trading_symbol.empty() ? "NULL" : trxn.quote(filing_fields.trading_symbol),
-        trxn.quote(SEC_fields.at("sic")), trxn.quote(base_form_type),
-        original_date_filed.empty() ? "NULL" : trxn.quote(original_date_filed),
-        trxn.quote(filing_fields.period_end_date), trxn.quote(filing_fields.period_context_ID),
-        filing_fields.shares_outstanding, "XBRL", schema_name,
-        amended_file_name.empty() ? "NULL" : trxn.quote(amended_file_name),
-        amended_date_filed.empty() ? "NULL" : trxn.quote(amended_date_filed));
-    auto filing_ID = trxn.query_value<std::string>(filing_ID_cmd);
-
     // now, the goal of all this...save all the financial values for the given time period.
 
+    static const std::string missing_label{"Missing Value"};
+
     int counter = 0;
-    auto inserter1{pqxx::stream_to::table(trxn, {schema_name, "sec_xbrl_data"},
-                                          {"filing_id", "xbrl_label", "label", "value", "context_id", "period_begin",
-                                           "period_end", "units", "decimals"})};
+    CopyTextWriter inserter1{trxn,
+                             {schema_name, "sec_xbrl_data"},
+                             {"filing_id", "xbrl_label", "label", "value", "context_id", "period_begin", "period_end",
+                              "units", "decimals"}};
 
     for (const auto &[label, context_ID, units, decimals, value] : gaap_fields)
     {
         ++counter;
-        inserter1.write_values(filing_ID, label, FindOrDefault(label_fields, label, "Missing Value"), value, context_ID,
-                               context_fields.at(context_ID).begin, context_fields.at(context_ID).end, units, decimals);
+        const auto &period = context_fields.at(context_ID);
+        inserter1.WriteRow(filing_ID, label, FindOrDefault(label_fields, label, missing_label), value, context_ID,
+                           period.begin, period.end, units, decimals);
     }
 
-    inserter1.complete();
-    trxn.commit();
+    inserter1.Complete();
     return true;
 } /* -----  end of function LoadDataToDB  ----- */
 
@@ -1031,7 +1015,8 @@ bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const EM::FilingData
  * =====================================================================================
  */
 bool LoadDataToDB_XLS(const EM::SEC_Header_fields &SEC_fields, const XLS_FinancialStatements &financial_statements,
-                      const std::string &schema_name, bool replace_DB_content)
+                      pqxx::dbtransaction &trxn, const std::string &schema_name, bool replace_DB_content,
+                      bool upsert_filing_ID)
 {
     auto form_type = SEC_fields.at("form_type");
     EM::sv base_form_type{form_type};
@@ -1040,141 +1025,241 @@ bool LoadDataToDB_XLS(const EM::SEC_Header_fields &SEC_fields, const XLS_Financi
         base_form_type.remove_suffix(2);
     }
 
-    // start stuffing the database.
-    // we only get here if we are going to add/replace data.
-    // but now that we are doing amended forms too, there are
-    // some wrinkles
-    // there are even more 'wrinkles' when we are running async.
-    // we may have multiple files that map to the samie cik/form/period_end_date that get through the
-    // check for existing data but clash on the insert.  In fact, we want insert failures.
-
-    pqxx::connection c{"dbname=sec_extracts user=extractor_pg"};
-    pqxx::work trxn{c};
-
-    // when checking for existing data, we don't filter on source
-    // since that may have changed (especially if we are processing an
-    // amended form)
-
-    auto save_original_data_cmd =
-        std::format("SELECT date_filed, file_name, amended_date_filed, amended_file_name FROM {3}.sec_filing_id WHERE"
-                    " cik = {0} AND form_type = {1} AND period_ending = {2}",
-                    trxn.quote(SEC_fields.at("cik")), trxn.quote(base_form_type),
-                    trxn.quote(SEC_fields.at("quarter_ending")), schema_name);
-    auto saved_original_data = trxn.exec(save_original_data_cmd);
-
-    std::string original_date_filed;
-    std::string original_file_name;
-    std::string amended_date_filed;
-    std::string amended_file_name;
-
-    if (!saved_original_data.empty())
+    std::string filing_ID;
+
+    if (upsert_filing_ID)
     {
-        if (!saved_original_data[0]["date_filed"].is_null())
+        auto upserted =
+            UpsertFilingID(trxn, CollectFilingIDValues(SEC_fields, financial_statements), replace_DB_content);
+        if (!upserted)
         {
-            original_date_filed = saved_original_data[0]["date_filed"].view();
+            return false;
         }
-        if (!saved_original_data[0]["file_name"].is_null())
-        {
-            original_file_name = saved_original_data[0]["file_name"].view();
-        }
-        if (!saved_original_data[0]["amended_date_filed"].is_null())
+        filing_ID = std::move(*upserted);
+    }
+    else
+    {
+        // start stuffing the database.
+        // we only get here if we are going to add/replace data.
+        // but now that we are doing amended forms too, there are
+        // some wrinkles
+        // there are even more 'wrinkles' when we are running async.
+        // we may have multiple files that map to the samie cik/form/period_end_date that get through the
+        // check for existing data but clash on the insert.  In fact, we want insert failures.
+
+        // when checking for existing data, we don't filter on source
+        // since that may have changed (especially if we are processing an
+        // amended form)
+
+        auto saved_original_data =
+            trxn.exec(pqxx::prepped{"filing_id_lookup"},
+                      pqxx::params{SEC_fields.at("cik"), base_form_type, SEC_fields.at("quarter_ending")});
+
+        std::string original_date_filed;
+        std::string original_file_name;
+        std::string amended_date_filed;
+        std::string amended_file_name;
+
+        if (!saved_original_data.empty())
         {
-            amended_date_filed = saved_original_data[0]["amended_date_filed"].view();
+            if (!saved_original_data[0]["date_filed"].is_null())
+            {
+                original_date_filed = saved_original_data[0]["date_filed"].view();
+            }
+            if (!saved_original_data[0]["file_name"].is_null())
+            {
+                original_file_name = saved_original_data[0]["file_name"].view();
+            }
+            if (!saved_original_data[0]["amended_date_filed"].is_null())
+            {
+                amended_date_filed = saved_original_data[0]["amended_date_filed"].view();
+            }
+            if (!saved_original_data[0]["amended_file_name"].is_null())
+            {
+                amended_file_name = saved_original_data[0]["amended_file_name"].view();
+            }
         }
-        if (!saved_original_data[0]["amended_file_name"].is_null())
+        else if (!form_type.ends_with("_A"))
         {
-            amended_file_name = saved_original_data[0]["amended_file_name"].view();
+            original_date_filed = SEC_fields.at("date_filed");
+            original_file_name = SEC_fields.at("file_name");
         }
-    }
-    else if (!form_type.ends_with("_A"))
-    {
-        original_date_filed = SEC_fields.at("date_filed");
-        original_file_name = SEC_fields.at("file_name");
-    }
 
-    //    std::cout << catenate("1 a: ", original_date_filed, " b: ", original_file_name, " c: ", amended_date_filed, "
-    //    d: ", amended_file_name, " e: ", SEC_fields.at("date_filed"), " f: ", SEC_fields.at("file_name"), '\n');
-    auto date_filed = StringToDateYMD("%F", SEC_fields.at("date_filed"));
-    std::chrono::year_month_day date_filed_amended = 1900y / 1 / 1d; // need to start somewhere
+        //    std::cout << catenate("1 a: ", original_date_filed, " b: ", original_file_name, " c: ",
+        //    amended_date_filed, " d: ", amended_file_name, " e: ", SEC_fields.at("date_filed"), " f: ",
+        //    SEC_fields.at("file_name"), '\n');
+        auto date_filed = StringToDateYMD("%F", SEC_fields.at("date_filed"));
+        std::chrono::year_month_day date_filed_amended = 1900y / 1 / 1d; // need to start somewhere
 
-    if (!amended_date_filed.empty())
-    {
-        date_filed_amended = StringToDateYMD("%F", amended_date_filed);
-    }
+        if (!amended_date_filed.empty())
+        {
+            date_filed_amended = StringToDateYMD("%F", amended_date_filed);
+        }
 
-    if (!replace_DB_content && form_type.ends_with("_A") && date_filed <= date_filed_amended)
-    {
-        return false;
-    }
+        if (!replace_DB_content && form_type.ends_with("_A") && date_filed <= date_filed_amended)
+        {
+            return false;
+        }
 
-    if (replace_DB_content || form_type.ends_with("_A") && date_filed > date_filed_amended)
-    {
-        if (form_type.ends_with("_A"))
+        if (replace_DB_content || form_type.ends_with("_A") && date_filed > date_filed_amended)
         {
-            amended_date_filed = SEC_fields.at("date_filed");
-            amended_file_name = SEC_fields.at("file_name");
+            if (form_type.ends_with("_A"))
+            {
+                amended_date_filed = SEC_fields.at("date_filed");
+                amended_file_name = SEC_fields.at("file_name");
+            }
+
+            trxn.exec(pqxx::prepped{"filing_id_delete"},
+                      pqxx::params{SEC_fields.at("cik"), base_form_type, SEC_fields.at("quarter_ending")});
         }
 
-        auto filing_ID_cmd = std::format("DELETE FROM {3}.sec_filing_id WHERE"
-                                         " cik = {0} AND form_type = {1} AND period_ending = {2}",
-                                         trxn.quote(SEC_fields.at("cik")), trxn.quote(base_form_type),
-                                         trxn.quote(SEC_fields.at("quarter_ending")), schema_name);
-        trxn.exec(filing_ID_cmd);
+        //    std::cout << catenate("2 a: ", original_date_filed, " b: ", original_file_name, " c: ",
+        //    amended_date_filed, " d: ", amended_file_name, " e: ", SEC_fields.at("date_filed"), " f: ",
+        //    SEC_fields.at("file_name"), '\n');
+        filing_ID =
+            trxn.exec(pqxx::prepped{"filing_id_insert"},
+                      pqxx::params{SEC_fields.at("cik"), SEC_fields.at("company_name"), NullIfEmpty(original_file_name),
+                                   std::optional<std::string>{}, SEC_fields.at("sic"), base_form_type,
+                                   NullIfEmpty(original_date_filed), SEC_fields.at("quarter_ending"),
+                                   std::optional<std::string>{}, financial_statements.outstanding_shares_, "XLS",
+                                   NullIfEmpty(amended_file_name), NullIfEmpty(amended_date_filed)})
+                .one_field()
+                .as<std::string>();
     }
 
-    //    std::cout << catenate("2 a: ", original_date_filed, " b: ", original_file_name, " c: ", amended_date_filed, "
-    //    d: ", amended_file_name, " e: ", SEC_fields.at("date_filed"), " f: ", SEC_fields.at("file_name"), '\n');
-    auto filing_ID_cmd = std::format(
-        "INSERT INTO {9}.sec_filing_id"
-        " (cik, company_name, file_name, symbol, sic, form_type, date_filed, period_ending,"
-        " shares_outstanding, data_source, amended_file_name, amended_date_filed)"
-        " VALUES ({0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}, '{10}', {11}, {12}) RETURNING filing_id",
-        trxn.quote(SEC_fields.at("cik")), trxn.quote(SEC_fields.at("company_name")),
-        original_file_name.empty() ? "NULL" : trxn.quote(original_file_name), "NULL", trxn.quote(SEC_fields.at("sic")),
-        trxn.quote(base_form_type), original_date_filed.empty() ? "NULL" : trxn.quote(original_date_filed),
-        trxn.quote(SEC_fields.at("quarter_ending")), financial_statements.outstanding_shares_, schema_name, "XLS",
-        amended_file_name.empty() ? "NULL" : trxn.quote(amended_file_name),
-        amended_date_filed.empty() ? "NULL" : trxn.quote(amended_date_filed));
-    // std::cout << filing_ID_cmd << '\n';
-    auto filing_ID = trxn.query_value<std::string>(filing_ID_cmd);
-
     // now, the goal of all this...save all the financial values for the given time period.
     std::initializer_list<std::string_view> tbl_columns = {std::string_view{"filing_ID"}, std::string_view{"label"},
                                                            std::string_view{"value"}};
 
     int counter = 0;
-    auto inserter1{pqxx::stream_to::table(trxn, {schema_name, "sec_bal_sheet_data"}, {"filing_id", "label", "value"})};
+    CopyTextWriter inserter1{trxn, {schema_name, "sec_bal_sheet_data"}, {"filing_id", "label", "value"}};
 
     for (const auto &[label, value] : financial_statements.balance_sheet_.values_)
     {
         ++counter;
-        inserter1.write_values(filing_ID, label.get(), value.get());
+        inserter1.WriteRow(filing_ID, label.get(), value.get());
     }
 
-    inserter1.complete();
+    inserter1.Complete();
 
-    auto inserter2{
-        pqxx::stream_to::table(trxn, {schema_name, "sec_stmt_of_ops_data"}, {"filing_id", "label", "value"})};
+    CopyTextWriter inserter2{trxn, {schema_name, "sec_stmt_of_ops_data"}, {"filing_id", "label", "value"}};
 
     for (const auto &[label, value] : financial_statements.statement_of_operations_.values_)
     {
         ++counter;
-        inserter2.write_values(filing_ID, label.get(), value.get());
+        inserter2.WriteRow(filing_ID, label.get(), value.get());
     }
 
-    inserter2.complete();
+    inserter2.Complete();
 
-    auto inserter3{pqxx::stream_to::table(trxn, {schema_name, "sec_cash_flows_data"}, {"filing_id", "label", "value"})};
+    CopyTextWriter inserter3{trxn, {schema_name, "sec_cash_flows_data"}, {"filing_id", "label", "value"}};
 
     for (const auto &[label, value] : financial_statements.cash_flows_.values_)
     {
         ++counter;
-        inserter3.write_values(filing_ID, label.get(), value.get());
+        inserter3.WriteRow(filing_ID, label.get(), value.get());
     }
 
-    inserter3.complete();
-
-    trxn.commit();
+    inserter3.Complete();
 
     return true;
 } /* -----  end of function LoadDataToDB_XLS  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  WriteDataToShards
+ *  Description:  same rows as LoadDataToDB but the filing_id is assigned when
+ *                the shard set is loaded.
+ * =====================================================================================
+ */
+void WriteDataToShards(const EM::SEC_Header_fields &SEC_fields, const EM::FilingData &filing_fields,
+                       const std::vector<EM::GAAP_Data> &gaap_fields, const EM::Extractor_Labels &label_fields,
+                       const EM::ContextPeriod &context_fields, ShardWriter &shard_writer)
+{
+    static const std::string missing_label{"Missing Value"};
+
+    shard_writer.AddFiling(CollectFilingIDValues(SEC_fields, filing_fields));
+
+    for (const auto &[label, context_ID, units, decimals, value] : gaap_fields)
+    {
+        const auto &period = context_fields.at(context_ID);
+        shard_writer.AddRow(ShardWriter::Table::e_xbrl_data, label, FindOrDefault(label_fields, label, missing_label),
+                            value, context_ID, period.begin, period.end, units, decimals);
+    }
+} /* -----  end of function WriteDataToShards  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  WriteDataToShards_XLS
+ *  Description:
+ * =====================================================================================
+ */
+void WriteDataToShards_XLS(const EM::SEC_Header_fields &SEC_fields,
+                           const XLS_FinancialStatements &financial_statements, ShardWriter &shard_writer)
+{
+    shard_writer.AddFiling(CollectFilingIDValues(SEC_fields, financial_statements));
+
+    for (const auto &[label, value] : financial_statements.balance_sheet_.values_)
+    {
+        shard_writer.AddRow(ShardWriter::Table::e_bal_sheet_data, label.get(), value.get());
+    }
+    for (const auto &[label, value] : financial_statements.statement_of_operations_.values_)
+    {
+        shard_writer.AddRow(ShardWriter::Table::e_stmt_of_ops_data, label.get(), value.get());
+    }
+    for (const auto &[label, value] : financial_statements.cash_flows_.values_)
+    {
+        shard_writer.AddRow(ShardWriter::Table::e_cash_flows_data, label.get(), value.get());
+    }
+} /* -----  end of function WriteDataToShards_XLS  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  ExportFacts
+ *  Description:
+ * =====================================================================================
+ */
+void ExportFacts(const EM::SEC_Header_fields &SEC_fields, const EM::FilingData &filing_fields,
+                 const std::vector<EM::GAAP_Data> &gaap_fields, const EM::Extractor_Labels &label_fields,
+                 const EM::ContextPeriod &context_fields, FactExporter &fact_exporter)
+{
+    static const std::string missing_label{"Missing Value"};
+
+    fact_exporter.StartFiling(CollectFilingIDValues(SEC_fields, filing_fields));
+
+    for (const auto &[label, context_ID, units, decimals, value] : gaap_fields)
+    {
+        const auto &period = context_fields.at(context_ID);
+        fact_exporter.AddXBRLFact(label, FindOrDefault(label_fields, label, missing_label), value, context_ID,
+                                  period.begin, period.end, units, decimals);
+    }
+
+    fact_exporter.EndFiling();
+} /* -----  end of function ExportFacts  ----- */
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  ExportFacts_XLS
+ *  Description:
+ * =====================================================================================
+ */
+void ExportFacts_XLS(const EM::SEC_Header_fields &SEC_fields, const XLS_FinancialStatements &financial_statements,
+                     FactExporter &fact_exporter)
+{
+    fact_exporter.StartFiling(CollectFilingIDValues(SEC_fields, financial_statements));
+
+    for (const auto &[label, value] : financial_statements.balance_sheet_.values_)
+    {
+        fact_exporter.AddStatementFact("bal_sheet", label.get(), value.get());
+    }
+    for (const auto &[label, value] : financial_statements.statement_of_operations_.values_)
+    {
+        fact_exporter.AddStatementFact("stmt_of_ops", label.get(), value.get());
+    }
+    for (const auto &[label, value] : financial_statements.cash_flows_.values_)
+    {
+        fact_exporter.AddStatementFact("cash_flows", label.get(), value.get());
+    }
+
+    fact_exporter.EndFiling();
+} /* -----  end of function ExportFacts_XLS  ----- */
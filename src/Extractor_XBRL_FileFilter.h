@@ -44,6 +44,8 @@
 
 #include "Extractor.h"
 #include "Extractor_Utils.h"
+#include "FactExport.h"
+#include "FilingShards.h"
 #include "XLS_Data.h"
 
 // Extracting the desired content from each financial statement section
@@ -180,15 +182,44 @@ EM::ContextPeriod ExtractContextDefinitions(const pugi::xml_document &instance_x
 
 pugi::xml_document ParseXMLContent(EM::XBRLContent document);
 
-EM::XBRLContent TrimExcessXML(EM::DocumentSection document);
+EM::XBRLContent TrimExcessXML(const EM::DocumentSection &document);
 
 std::string ConvertPeriodEndDateToContextName(EM::sv period_end_date);
 
+FilingIDValues CollectFilingIDValues(const EM::SEC_Header_fields &SEC_fields, const EM::FilingData &filing_fields);
+
+FilingIDValues CollectFilingIDValues(const EM::SEC_Header_fields &SEC_fields,
+                                     const XLS_FinancialStatements &financial_statements);
+
+// these write into the caller's transaction. committing it is up to the caller
+// which may be batching several filings together.
+// upsert_filing_ID selects UpsertFilingID over the lookup/delete/insert sequence.
+
 bool LoadDataToDB(const EM::SEC_Header_fields &SEC_fields, const EM::FilingData &filing_fields,
                   const std::vector<EM::GAAP_Data> &gaap_fields, const EM::Extractor_Labels &label_fields,
-                  const EM::ContextPeriod &context_fields, const std::string &schema_name, bool replace_DB_content);
+                  const EM::ContextPeriod &context_fields, pqxx::dbtransaction &trxn, const std::string &schema_name,
+                  bool replace_DB_content, bool upsert_filing_ID);
 
 bool LoadDataToDB_XLS(const EM::SEC_Header_fields &SEC_fields, const XLS_FinancialStatements &financial_statements,
-                      const std::string &schema_name, bool replace_DB_content);
+                      pqxx::dbtransaction &trxn, const std::string &schema_name, bool replace_DB_content,
+                      bool upsert_filing_ID);
+
+// offline alternative to the above. see FilingShards.h.
+
+void WriteDataToShards(const EM::SEC_Header_fields &SEC_fields, const EM::FilingData &filing_fields,
+                       const std::vector<EM::GAAP_Data> &gaap_fields, const EM::Extractor_Labels &label_fields,
+                       const EM::ContextPeriod &context_fields, ShardWriter &shard_writer);
+
+void WriteDataToShards_XLS(const EM::SEC_Header_fields &SEC_fields,
+                           const XLS_FinancialStatements &financial_statements, ShardWriter &shard_writer);
+
+// for analysis outside the DB. see FactExport.h.
+
+void ExportFacts(const EM::SEC_Header_fields &SEC_fields, const EM::FilingData &filing_fields,
+                 const std::vector<EM::GAAP_Data> &gaap_fields, const EM::Extractor_Labels &label_fields,
+                 const EM::ContextPeriod &context_fields, FactExporter &fact_exporter);
+
+void ExportFacts_XLS(const EM::SEC_Header_fields &SEC_fields, const XLS_FinancialStatements &financial_statements,
+                     FactExporter &fact_exporter);
 
 #endif /* ----- #ifndef _EXTRACTOR_XBRL_FILEFILTER_INC_  ----- */
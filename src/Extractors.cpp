@@ -38,6 +38,7 @@
 #include <xlsxio_read.h>
 
 #include <boost/regex.hpp>
+#include <cerrno>
 #include <fstream>
 #include <iostream>
 #include <range/v3/algorithm/find.hpp>
@@ -45,16 +46,16 @@
 #include <range/v3/algorithm/for_each.hpp>
 #include <range/v3/view/filter.hpp>
 #include <string>
+#include <system_error>
 
 #include "SEC_Header.h"
+#include "UUDecode.h"
 #include "XLS_Data.h"
 #include "spdlog/spdlog.h"
 
 namespace fs = std::filesystem;
 using namespace std::string_literals;
 
-#include "pstreams/pstream.h"
-
 const std::string::size_type START_WITH{1000000};
 
 const boost::regex regex_fname{R"***(^<FILENAME>(.*?)$)***"};
@@ -157,7 +158,7 @@ void XLS_data::UseExtractor(EM::FileName file_name, EM::FileContent file_content
 
     for (auto &doc : documents)
     {
-        auto document = doc.get();
+        auto document = doc.content_;
         if (auto ss_loc = document.find(R"***(.xlsx)***"); ss_loc != EM::sv::npos)
         {
             std::cout << "spread sheet\n";
@@ -203,65 +204,9 @@ void XLS_data::UseExtractor(EM::FileName file_name, EM::FileContent file_content
 
 std::vector<char> XLS_data::ConvertDataAndWriteToDisk(EM::FileName output_file_name, EM::sv content)
 {
-    // we write our table out to a temp file and then call uudecode on it.
-    //
-    // creating a proper unique temp file is not straight-forward.
-    // this approach tries to create a unique directory first then write a file into it.
-    // directory creation is an atomic operation in Linux.  If it succeeds,
-    // the directory did not already exist so it can safely be used.
-
-    fs::path temp_file_name;
-    std::error_code ec;
-    std::array<char, L_tmpnam> buffer{'\0'};
-
-    // give it 5 tries...
-
-    int n = 0;
-    while (true)
-    {
-        temp_file_name = fs::temp_directory_path();
-        if (std::tmpnam(buffer.data()) != nullptr)
-        {
-            temp_file_name /= buffer.data();
-            if (bool did_create = fs::create_directory(temp_file_name, ec); did_create)
-            {
-                break;
-            }
-            ++n;
-            if (n >= 5)
-            {
-                throw std::runtime_error("Can't create temp directory.\n");
-            }
-        }
-        else
-        {
-            throw std::runtime_error("Can't create temp file name.\n");
-        }
-    }
-
-    temp_file_name /= "encoded_data.txt";
-
-    std::ofstream temp_file{temp_file_name};
+    // decode in memory then write out the result. no temp files needed.
 
-    // it seems it's possible to have uuencoded data with 'short' lines
-    // so, we need to be sure each line is 61 bytes long.
-
-    auto lines = split_string<EM::sv>(content, "\n");
-    for (auto line : lines)
-    {
-        temp_file.write(line.data(), line.size());
-        if (line == "end")
-        {
-            temp_file.put('\n');
-            break;
-        }
-        for (int i = line.size(); i < 61; ++i)
-        {
-            temp_file.put(' ');
-        }
-        temp_file.put('\n');
-    }
-    temp_file.close();
+    auto result = UUDecode(content);
 
     auto output_directory = output_file_name.get().parent_path();
     if (!fs::exists(output_directory))
@@ -269,130 +214,23 @@ std::vector<char> XLS_data::ConvertDataAndWriteToDisk(EM::FileName output_file_n
         fs::create_directories(output_directory);
     }
 
-    redi::ipstream in(catenate("uudecode -o ", output_file_name.get().string(), ' ', temp_file_name.string()));
-    // redi::ipstream in("html2text -b 0 --ignore-emphasis --ignore-images --ignore-links " + temp_file_name.string());
-
-    std::vector<char> str1;
-
-    // we use a buffer and the readsome function so that we will get any
-    // embedded return characters (which would be stripped off if we did
-    // readline.
-
-    std::array<char, 1024> buf;
-    std::streamsize bytes_read;
-    while (!in.eof())
+    std::ofstream output{output_file_name.get(), std::ios::out | std::ios::binary};
+    if (!output)
     {
-        while ((bytes_read = in.out().readsome(buf.data(), buf.max_size())) > 0)
-        {
-            str1.insert(str1.end(), buf.data(), buf.data() + bytes_read);
-        }
+        std::error_code err{errno, std::system_category()};
+        throw std::system_error{err, catenate("Unable to open output file: ", output_file_name.get().string())};
     }
+    output.write(result.data(), result.size());
+    output.close();
 
-    // let's be neat and not leave temp files laying around
-
-    fs::remove(temp_file_name);
-
-    // I know I could this in 1 call but...
-
-    fs::remove(temp_file_name.remove_filename());
-    return str1;
+    return result;
 }
 std::vector<char> XLS_data::ConvertDataToString(EM::sv content)
 {
-    // we write our XLS file to the std::in of the decoder
-    // and read the decoder's std::out into a charater vector.
-    // No temp files involved.
-
-    redi::pstream out_in("uudecode -o /dev/stdout ",
-                         redi::pstreams::pstdin | redi::pstreams::pstdout | redi::pstreams::pstderr);
-    BOOST_ASSERT_MSG(out_in.is_open(), "Failed to open subprocess.");
+    // we decode our XLS file straight into a charater vector.
+    // No subprocess and no temp files involved.
 
-    std::array<char, 4096> buf{'\0'};
-    std::streamsize bytes_read;
-
-    std::vector<char> result;
-    std::string error_msg;
-
-    // it seems it's possible to have uuencoded data with 'short' lines
-    // so, we need to be sure each line is 61 bytes long.
-
-    auto lines = split_string<EM::sv>(content, "\n");
-    for (auto line : lines)
-    {
-        out_in.write(line.data(), line.size());
-        if (line == "end")
-        {
-            out_in.put('\n');
-            break;
-        }
-        for (int i = line.size(); i < 61; ++i)
-        {
-            out_in.put(' ');
-        }
-        out_in.put('\n');
-
-        // for short files, we can write all the lines
-        // and then go read the conversion output
-        // BUT for longer files, we may need to read
-        // output along the way to avoid deadlocks...
-        // write won't complete until conversion output
-        // is read.
-        do
-        {
-            bytes_read = out_in.out().readsome(buf.data(), buf.max_size());
-            result.insert(result.end(), buf.data(), buf.data() + bytes_read);
-        } while (bytes_read != 0);
-
-        do
-        {
-            bytes_read = out_in.err().readsome(buf.data(), buf.max_size());
-            error_msg.append(buf.data(), bytes_read);
-        } while (bytes_read != 0);
-    }
-    //	write eod marker
-
-    out_in << redi::peof;
-
-    // we use a buffer and the readsome function so that we will get any
-    // embedded return characters (which would be stripped off if we did
-    // readline.
-
-    bool finished[2] = {false, false};
-
-    while (!finished[0] || !finished[1])
-    {
-        if (!finished[1])
-        {
-            while ((bytes_read = out_in.out().readsome(buf.data(), buf.max_size())) > 0)
-            {
-                result.insert(result.end(), buf.data(), buf.data() + bytes_read);
-            }
-            if (out_in.eof())
-            {
-                finished[1] = true;
-                if (!finished[0])
-                    out_in.clear();
-            }
-        }
-        if (!finished[0])
-        {
-            while ((bytes_read = out_in.err().readsome(buf.data(), buf.max_size())) > 0)
-            {
-                error_msg.append(buf.data(), bytes_read);
-            }
-            if (out_in.eof())
-            {
-                finished[0] = true;
-                if (!finished[1])
-                    out_in.clear();
-            }
-        }
-    }
-
-    auto return_code = out_in.close();
-
-    BOOST_ASSERT_MSG(return_code == 0, catenate("Problem decoding file: ", error_msg).c_str());
-    return result;
+    return UUDecode(content);
 }
 
 EM::Extractor_Values XLS_data::ExtractDataFromXLS(std::vector<char> report)
@@ -509,7 +347,7 @@ void Count_XLS::UseExtractor(EM::FileName file_name, EM::FileContent file_conten
 
     for (auto &doc : documents)
     {
-        auto document = doc.get();
+        auto document = doc.content_;
         if (auto ss_loc = document.find(R"***(.xlsx)***"); ss_loc != EM::sv::npos)
         {
             ++XLS_counter;
@@ -0,0 +1,401 @@
+// =====================================================================================
+//
+//       Filename:  FactExport.cpp
+//
+//    Description:  Write extracted values to files partitioned by form type and
+//                  period for bulk analysis outside the DB.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 06:21:13 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "FactExport.h"
+
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <system_error>
+
+#include <arrow/io/file.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+
+#include <spdlog/spdlog.h>
+
+#include "FilingShards.h"
+
+namespace rng = std::ranges;
+
+namespace
+{
+constexpr int k_value_precision{20};
+constexpr int k_value_scale{4};
+constexpr int64_t k_row_group_rows{128 * 1024};
+
+void ThrowIfFailed(const arrow::Status &status, std::string_view what)
+{
+    if (!status.ok())
+    {
+        throw ExtractorException(catenate(what, status.ToString()));
+    }
+}
+
+template <typename T> T ValueOrThrow(arrow::Result<T> result, std::string_view what)
+{
+    ThrowIfFailed(result.status(), what);
+    return std::move(result).ValueUnsafe();
+}
+
+template <typename Builder> arrow::Status AppendOrNull(Builder &builder, std::optional<std::string_view> value)
+{
+    return value ? builder.Append(*value) : builder.AppendNull();
+}
+
+// the value the DB would store or nothing if it would turn it down.
+
+std::optional<arrow::Decimal128> DecimalValue(std::string_view value)
+{
+    auto text = DecimalText(value, k_value_scale);
+    if (!text)
+    {
+        return std::nullopt;
+    }
+    arrow::Decimal128 decimal;
+    int32_t precision{0};
+    int32_t scale{0};
+    if (!arrow::Decimal128::FromString(*text, &decimal, &precision, &scale).ok() || precision > k_value_precision)
+    {
+        return std::nullopt;
+    }
+    return decimal;
+}
+
+} // namespace
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  DecimalText
+ *  Description:
+ * =====================================================================================
+ */
+std::optional<std::string> DecimalText(std::string_view value, int scale)
+{
+    bool negative{false};
+    if (!value.empty() && (value.front() == '-' || value.front() == '+'))
+    {
+        negative = value.front() == '-';
+        value.remove_prefix(1);
+    }
+
+    const auto point = value.find('.');
+    const auto whole = value.substr(0, point);
+    const auto fraction = point == std::string_view::npos ? std::string_view{} : value.substr(point + 1);
+
+    auto is_digits = [](std::string_view text) {
+        return rng::all_of(text, [](char c) { return c >= '0' && c <= '9'; });
+    };
+    if ((whole.empty() && fraction.empty()) || !is_digits(whole) || !is_digits(fraction))
+    {
+        return std::nullopt;
+    }
+
+    // all the digits we keep, scaled up to an integer, then rounded on the first one we drop.
+
+    const auto keep = static_cast<size_t>(scale);
+    std::string digits{whole};
+    digits.append(fraction.substr(0, keep));
+    digits.append(keep - std::min(fraction.size(), keep), '0');
+
+    if (fraction.size() > keep && fraction[keep] >= '5')
+    {
+        auto i = digits.size();
+        while (i > 0 && digits[i - 1] == '9')
+        {
+            digits[--i] = '0';
+        }
+        if (i == 0)
+        {
+            digits.insert(0, 1, '1');
+        }
+        else
+        {
+            ++digits[i - 1];
+        }
+    }
+
+    // at least 1 digit in front of the point but no extra zeros.
+
+    if (digits.size() < keep + 1)
+    {
+        digits.insert(0, keep + 1 - digits.size(), '0');
+    }
+    digits.erase(0, std::min(digits.find_first_not_of('0'), digits.size() - keep - 1));
+
+    std::string result;
+    if (negative && digits.find_first_not_of('0') != std::string::npos)
+    {
+        result += '-';
+    }
+    result.append(digits, 0, digits.size() - keep);
+    if (keep > 0)
+    {
+        result += '.';
+        result.append(digits, digits.size() - keep);
+    }
+    return result;
+} /* -----  end of function DecimalText  ----- */
+
+FactExporter::FactBuilders::FactBuilders() : value_{arrow::decimal128(k_value_precision, k_value_scale)}
+{
+} // -----  end of method FactExporter::FactBuilders::FactBuilders  (constructor)  -----
+
+void FactExporter::FactBuilders::Reset()
+{
+    for (auto *builder : {&cik_, &file_name_, &date_filed_, &data_source_, &statement_, &context_ID_,
+                          &period_begin_, &period_end_, &units_, &decimals_})
+    {
+        builder->Reset();
+    }
+
+    // a dictionary builder keeps its dictionary after a Finish. each filing
+    // starts a new one so a filing's rows only carry the labels they use.
+
+    xbrl_label_.ResetFull();
+    label_.ResetFull();
+    value_.Reset();
+} // -----  end of method FactExporter::FactBuilders::Reset  -----
+
+FactExporter::FactExporter(const fs::path &directory, int worker)
+    : directory_{directory},
+      writer_name_{OfflineWriterName(worker)},
+      schema_{arrow::schema({arrow::field("cik", arrow::utf8(), false),
+                             arrow::field("file_name", arrow::utf8(), false),
+                             arrow::field("date_filed", arrow::utf8(), false),
+                             arrow::field("data_source", arrow::utf8(), false),
+                             arrow::field("statement", arrow::utf8(), false),
+                             arrow::field("xbrl_label", arrow::dictionary(arrow::int32(), arrow::utf8())),
+                             arrow::field("label", arrow::dictionary(arrow::int32(), arrow::utf8()), false),
+                             arrow::field("value", arrow::decimal128(k_value_precision, k_value_scale)),
+                             arrow::field("context_id", arrow::utf8()),
+                             arrow::field("period_begin", arrow::utf8()),
+                             arrow::field("period_end", arrow::utf8()),
+                             arrow::field("units", arrow::utf8()),
+                             arrow::field("decimals", arrow::utf8())})}
+{
+} // -----  end of method FactExporter::FactExporter  (constructor)  -----
+
+FactExporter::~FactExporter()
+{
+    try
+    {
+        Close();
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(catenate("Problem closing fact export files for: ", writer_name_, ". ", e.what()));
+    }
+} // -----  end of method FactExporter::~FactExporter  -----
+
+void FactExporter::StartFiling(const FilingIDValues &values)
+{
+    filing_ = values;
+
+    auto partition = catenate("form_type=", values.form_type_, "/period_ending=", values.period_ending_);
+    auto [entry, is_new] = partitions_.try_emplace(partition);
+    if (is_new)
+    {
+        entry->second.path_ = directory_ / partition;
+    }
+    partition_ = &entry->second;
+
+    builders_.Reset();
+} // -----  end of method FactExporter::StartFiling  -----
+
+void FactExporter::AddRow(std::string_view statement, std::optional<std::string_view> xbrl_label,
+                          std::string_view label, std::string_view value, std::optional<std::string_view> context_ID,
+                          std::optional<std::string_view> period_begin, std::optional<std::string_view> period_end,
+                          std::optional<std::string_view> units, std::optional<std::string_view> decimals)
+{
+    auto &b = builders_;
+    const auto decimal = DecimalValue(value);
+
+    for (const auto &status :
+         {b.cik_.Append(filing_.cik_), b.file_name_.Append(filing_.file_name_),
+          b.date_filed_.Append(filing_.date_filed_), b.data_source_.Append(filing_.data_source_),
+          b.statement_.Append(statement), AppendOrNull(b.xbrl_label_, xbrl_label), b.label_.Append(label),
+          decimal ? b.value_.Append(*decimal) : b.value_.AppendNull(), AppendOrNull(b.context_ID_, context_ID),
+          AppendOrNull(b.period_begin_, period_begin), AppendOrNull(b.period_end_, period_end),
+          AppendOrNull(b.units_, units), AppendOrNull(b.decimals_, decimals)})
+    {
+        ThrowIfFailed(status, "Problem adding fact export row: ");
+    }
+} // -----  end of method FactExporter::AddRow  -----
+
+void FactExporter::AddXBRLFact(std::string_view xbrl_label, std::string_view label, std::string_view value,
+                               std::string_view context_ID, std::string_view period_begin,
+                               std::string_view period_end, std::string_view units, std::string_view decimals)
+{
+    AddRow("xbrl", xbrl_label, label, value, context_ID, period_begin, period_end, units, decimals);
+} // -----  end of method FactExporter::AddXBRLFact  -----
+
+void FactExporter::AddStatementFact(std::string_view statement, std::string_view label, std::string_view value)
+{
+    AddRow(statement, std::nullopt, label, value, std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+           std::nullopt);
+} // -----  end of method FactExporter::AddStatementFact  -----
+
+void FactExporter::EndFiling()
+{
+    auto &b = builders_;
+    const int64_t rows = b.label_.length();
+
+    std::vector<std::shared_ptr<arrow::Array>> columns;
+    for (auto *builder : std::initializer_list<arrow::ArrayBuilder *>{
+             &b.cik_, &b.file_name_, &b.date_filed_, &b.data_source_, &b.statement_, &b.xbrl_label_, &b.label_,
+             &b.value_, &b.context_ID_, &b.period_begin_, &b.period_end_, &b.units_, &b.decimals_})
+    {
+        columns.push_back(ValueOrThrow(builder->Finish(), "Problem finishing fact export rows: "));
+    }
+    b.Reset();
+
+    auto &partition = *partition_;
+    partition_ = nullptr;
+    if (rows == 0)
+    {
+        return;
+    }
+
+    partition.filings_.push_back(arrow::RecordBatch::Make(schema_, rows, std::move(columns)));
+    partition.rows_ += rows;
+    held_rows_ += rows;
+
+    // a failed write leaves whatever it was writing held so the filings
+    // from before get another chance. this one is reported as failed so it
+    // doesn't stay.
+
+    try
+    {
+        if (partition.rows_ >= k_rows_per_file)
+        {
+            WritePartition(partition);
+        }
+        else if (held_rows_ >= k_max_held_rows)
+        {
+            WritePartition(
+                rng::max_element(partitions_, {}, [](const auto &entry) { return entry.second.rows_; })->second);
+        }
+    }
+    catch (...)
+    {
+        partition.filings_.pop_back();
+        partition.rows_ -= rows;
+        held_rows_ -= rows;
+        throw;
+    }
+} // -----  end of method FactExporter::EndFiling  -----
+
+void FactExporter::DropFiling()
+{
+    builders_.Reset();
+    partition_ = nullptr;
+} // -----  end of method FactExporter::DropFiling  -----
+
+void FactExporter::WritePartition(Partition &partition)
+{
+    fs::create_directories(partition.path_);
+
+    const auto file_name = catenate("facts-", writer_name_, '-', std::format("{:06}", ++file_number_), ".parquet");
+    const auto partial_path = partition.path_ / catenate('.', file_name);
+
+    try
+    {
+        // each filing has its own dictionaries. combining them gives the file 1
+        // dictionary for each label column.
+
+        auto facts = ValueOrThrow(arrow::Table::FromRecordBatches(schema_, partition.filings_),
+                                  "Problem collecting fact export rows: ");
+        facts = ValueOrThrow(facts->CombineChunks(), "Problem combining fact export rows: ");
+
+        auto output = ValueOrThrow(arrow::io::FileOutputStream::Open(partial_path.string()),
+                                   catenate("Unable to create fact export file: ", partial_path.string(), ". "));
+        auto properties = parquet::WriterProperties::Builder().compression(parquet::Compression::ZSTD)->build();
+        auto arrow_properties = parquet::ArrowWriterProperties::Builder().store_schema()->build();
+        auto writer = ValueOrThrow(
+            parquet::arrow::FileWriter::Open(*schema_, arrow::default_memory_pool(), output, properties,
+                                             arrow_properties),
+            catenate("Unable to start fact export file: ", partial_path.string(), ". "));
+
+        const auto problem_writing = catenate("Problem writing fact export file: ", partial_path.string(), ". ");
+        ThrowIfFailed(writer->WriteTable(*facts, k_row_group_rows), problem_writing);
+        ThrowIfFailed(writer->Close(), problem_writing);
+        ThrowIfFailed(output->Close(), problem_writing);
+
+        // only now can a reader see it.
+
+        fs::rename(partial_path, partition.path_ / file_name);
+    }
+    catch (...)
+    {
+        std::error_code ec;
+        fs::remove(partial_path, ec);
+        throw;
+    }
+
+    spdlog::info(catenate("Wrote fact export file: ", (partition.path_ / file_name).string(), " with: ",
+                          partition.filings_.size(), " filings, ", partition.rows_, " rows."));
+
+    held_rows_ -= partition.rows_;
+    partition.filings_.clear();
+    partition.rows_ = 0;
+} // -----  end of method FactExporter::WritePartition  -----
+
+void FactExporter::Close()
+{
+    // keep going past a partition which can't be written so as much as
+    // possible gets out. the first problem is passed along.
+
+    std::exception_ptr problem;
+    for (auto &[name, partition] : partitions_)
+    {
+        if (partition.rows_ == 0)
+        {
+            continue;
+        }
+        try
+        {
+            WritePartition(partition);
+        }
+        catch (...)
+        {
+            if (!problem)
+            {
+                problem = std::current_exception();
+            }
+        }
+    }
+    if (problem)
+    {
+        std::rethrow_exception(problem);
+    }
+} // -----  end of method FactExporter::Close  -----
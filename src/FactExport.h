@@ -0,0 +1,169 @@
+// =====================================================================================
+//
+//       Filename:  FactExport.h
+//
+//    Description:  Write extracted values to Parquet files partitioned by form
+//                  type and period for bulk analysis outside the DB.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 06:21:13 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+// the layout is the usual 'hive' style most columnar tools can read:
+//
+//      DIR/form_type=10-Q/period_ending=2020-03-31/facts-<writer>-000001.parquet
+//
+// a file only ever holds whole filings. xbrl_label and label are
+// dictionary<int32, utf8> so each label is stored once per file. value is
+// decimal128(20, 4), the same as the DB's NUMERIC(20, 4). a value which isn't
+// a number or doesn't fit is null. statement is 'xbrl' for XBRL facts,
+// otherwise the statement the value came from.
+// files are written under a name starting with '.', which dataset readers
+// skip, and renamed once complete.
+
+#ifndef FACTEXPORT_H_
+#define FACTEXPORT_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "Extractor_Utils.h"
+
+// a value as decimal text with exactly 'scale' digits after the point, rounded
+// half away from zero like the DB does. nothing if it is not a plain decimal number.
+
+std::optional<std::string> DecimalText(std::string_view value, int scale);
+
+// =====================================================================================
+//        Class:  FactExporter
+//  Description:  Exports filings for 1 worker. A filing's rows are built up
+//                until EndFiling so one which fails part way through can be
+//                dropped. Finished filings are held for each partition and
+//                written once there are enough of them for a good sized file
+//                or at Close.
+//
+//                Not thread safe. Each worker needs its own.
+// =====================================================================================
+
+class FactExporter
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    FactExporter(const fs::path &directory, int worker);
+    FactExporter(const FactExporter &rhs) = delete;
+    FactExporter(FactExporter &&rhs) = delete;
+
+    ~FactExporter();
+
+    // ====================  MUTATORS      =======================================
+
+    void StartFiling(const FilingIDValues &values);
+
+    void AddXBRLFact(std::string_view xbrl_label, std::string_view label, std::string_view value,
+                     std::string_view context_ID, std::string_view period_begin, std::string_view period_end,
+                     std::string_view units, std::string_view decimals);
+    void AddStatementFact(std::string_view statement, std::string_view label, std::string_view value);
+
+    // if writing fails, the filing is not kept. filings held from before are
+    // kept for the next try.
+
+    void EndFiling();
+    void DropFiling();
+
+    // writes out all the filings still held.
+
+    void Close();
+
+    // ====================  OPERATORS     =======================================
+
+    FactExporter &operator=(const FactExporter &rhs) = delete;
+    FactExporter &operator=(FactExporter &&rhs) = delete;
+
+private:
+    static constexpr int64_t k_rows_per_file{1'000'000};
+    static constexpr int64_t k_max_held_rows{4'000'000};
+
+    // 1 builder for each column.
+
+    struct FactBuilders
+    {
+        FactBuilders();
+        void Reset();
+
+        arrow::StringBuilder cik_;
+        arrow::StringBuilder file_name_;
+        arrow::StringBuilder date_filed_;
+        arrow::StringBuilder data_source_;
+        arrow::StringBuilder statement_;
+        arrow::StringDictionary32Builder xbrl_label_;
+        arrow::StringDictionary32Builder label_;
+        arrow::Decimal128Builder value_;
+        arrow::StringBuilder context_ID_;
+        arrow::StringBuilder period_begin_;
+        arrow::StringBuilder period_end_;
+        arrow::StringBuilder units_;
+        arrow::StringBuilder decimals_;
+    };
+
+    struct Partition
+    {
+        fs::path path_;
+        std::vector<std::shared_ptr<arrow::RecordBatch>> filings_;
+        int64_t rows_{0};
+    };
+
+    void AddRow(std::string_view statement, std::optional<std::string_view> xbrl_label, std::string_view label,
+                std::string_view value, std::optional<std::string_view> context_ID,
+                std::optional<std::string_view> period_begin, std::optional<std::string_view> period_end,
+                std::optional<std::string_view> units, std::optional<std::string_view> decimals);
+    void WritePartition(Partition &partition);
+
+    // ====================  DATA MEMBERS  =======================================
+
+    fs::path directory_;
+    std::string writer_name_;
+    std::shared_ptr<arrow::Schema> schema_;
+
+    std::unordered_map<std::string, Partition> partitions_;
+    int64_t held_rows_{0};
+    int file_number_{0};
+
+    // the filing in process.
+
+    FactBuilders builders_;
+    Partition *partition_{nullptr};
+    FilingIDValues filing_;
+
+}; // -----  end of class FactExporter  -----
+
+#endif /* FACTEXPORT_H_ */
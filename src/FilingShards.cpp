@@ -0,0 +1,320 @@
+// =====================================================================================
+//
+//       Filename:  FilingShards.cpp
+//
+//    Description:  Write extracted filings to COPY-ready shard files and load
+//                  them into the DB later.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 04:06:52 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "FilingShards.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+#include <spdlog/spdlog.h>
+
+namespace rng = std::ranges;
+
+namespace
+{
+// file names within a set, in Table order.
+
+constexpr std::array<const char *, 5> k_table_files{"filings.copy", "xbrl_data.copy", "bal_sheet_data.copy",
+                                                    "stmt_of_ops_data.copy", "cash_flows_data.copy"};
+
+constexpr std::string_view k_partial_suffix{".partial"};
+constexpr std::string_view k_loaded_suffix{".loaded"};
+
+// temp table for each shard file, in Table order. columns are in file order.
+
+constexpr std::array<const char *, 5> k_shard_tables{
+    "CREATE TEMP TABLE shard_filings (local_id BIGINT, cik TEXT, company_name TEXT, file_name TEXT, symbol TEXT,"
+    " sic TEXT, form_type TEXT, date_filed DATE, period_ending DATE, period_context_id TEXT,"
+    " shares_outstanding NUMERIC, data_source TEXT, is_amended BOOLEAN) ON COMMIT DROP",
+    "CREATE TEMP TABLE shard_xbrl_data (local_id BIGINT, xbrl_label TEXT, label TEXT, value NUMERIC(20, 4),"
+    " context_id TEXT, period_begin DATE, period_end DATE, units TEXT, decimals TEXT) ON COMMIT DROP",
+    "CREATE TEMP TABLE shard_bal_sheet_data (local_id BIGINT, label TEXT, value NUMERIC(20, 4)) ON COMMIT DROP",
+    "CREATE TEMP TABLE shard_stmt_of_ops_data (local_id BIGINT, label TEXT, value NUMERIC(20, 4)) ON COMMIT DROP",
+    "CREATE TEMP TABLE shard_cash_flows_data (local_id BIGINT, label TEXT, value NUMERIC(20, 4)) ON COMMIT DROP"};
+
+constexpr std::array<const char *, 5> k_shard_table_names{"shard_filings", "shard_xbrl_data", "shard_bal_sheet_data",
+                                                          "shard_stmt_of_ops_data", "shard_cash_flows_data"};
+
+// pass the file through a COPY in big pieces. write_raw_line adds a newline
+// so each piece has to end at the end of a row.
+
+void CopyFileToTable(const fs::path &file_path, const char *table_name, pqxx::dbtransaction &trxn)
+{
+    std::ifstream input{file_path, std::ios::in | std::ios::binary};
+    if (!input)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                catenate("Unable to open shard file: ", file_path.string()));
+    }
+
+    auto inserter{pqxx::stream_to::table(trxn, {table_name})};
+
+    std::vector<char> block(4 * 1024 * 1024);
+    std::string rows;
+    while (input.read(block.data(), block.size()) || input.gcount() > 0)
+    {
+        rows.append(block.data(), input.gcount());
+        auto last_newline = rows.rfind('\n');
+        if (last_newline == std::string::npos)
+        {
+            continue;
+        }
+        inserter.write_raw_line(EM::sv{rows}.substr(0, last_newline));
+        rows.erase(0, last_newline + 1);
+    }
+    BOOST_ASSERT_MSG(rows.empty(),
+                     catenate("Shard file does not end with a complete row: ", file_path.string()).c_str());
+
+    inserter.complete();
+} /* -----  end of function CopyFileToTable  ----- */
+
+} // namespace
+
+ShardWriter::ShardWriter(const fs::path &directory, int worker, size_t max_set_bytes)
+    : directory_{directory}, writer_name_{OfflineWriterName(worker)}, max_set_bytes_{max_set_bytes}
+{
+} // -----  end of method ShardWriter::ShardWriter  (constructor)  -----
+
+ShardWriter::~ShardWriter()
+{
+    try
+    {
+        Close();
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(catenate("Problem closing shard set: ", set_path_.string(), ". ", e.what()));
+    }
+} // -----  end of method ShardWriter::~ShardWriter  -----
+
+void ShardWriter::OpenSet()
+{
+    set_path_ = directory_ / catenate(writer_name_, '-', std::format("{:06}", ++set_number_), k_partial_suffix);
+    fs::create_directories(set_path_);
+
+    for (size_t i = 0; i < k_table_count; ++i)
+    {
+        files_[i].open(set_path_ / k_table_files[i], std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!files_[i])
+        {
+            throw std::system_error(errno, std::generic_category(),
+                                    catenate("Unable to create shard file: ", (set_path_ / k_table_files[i]).string()));
+        }
+    }
+    set_bytes_ = 0;
+    filing_number_ = 0;
+    set_is_open_ = true;
+} // -----  end of method ShardWriter::OpenSet  -----
+
+void ShardWriter::AddFiling(const FilingIDValues &values)
+{
+    // the previous filing is complete so this is where we write out what
+    // we have or move on to a new set.
+
+    if (set_is_open_)
+    {
+        size_t buffered_bytes{0};
+        for (size_t i = 0; i < k_table_count; ++i)
+        {
+            if (buffers_[i].size() >= k_flush_size)
+            {
+                FlushTable(static_cast<Table>(i));
+            }
+            buffered_bytes += buffers_[i].size();
+        }
+        if (set_bytes_ + buffered_bytes >= max_set_bytes_)
+        {
+            Close();
+        }
+    }
+    if (!set_is_open_)
+    {
+        OpenSet();
+    }
+
+    for (size_t i = 0; i < k_table_count; ++i)
+    {
+        filing_starts_[i] = buffers_[i].size();
+    }
+
+    ++filing_number_;
+    AddRow(Table::e_filings, values.cik_, values.company_name_, values.file_name_, values.symbol_, values.sic_,
+           values.form_type_, values.date_filed_, values.period_ending_, values.period_context_ID_,
+           NullIfEmpty(values.shares_outstanding_), values.data_source_, values.is_amended_);
+} // -----  end of method ShardWriter::AddFiling  -----
+
+void ShardWriter::DropFiling()
+{
+    if (!set_is_open_)
+    {
+        return;
+    }
+    for (size_t i = 0; i < k_table_count; ++i)
+    {
+        buffers_[i].resize(filing_starts_[i]);
+    }
+    --filing_number_;
+} // -----  end of method ShardWriter::DropFiling  -----
+
+void ShardWriter::FlushTable(Table table)
+{
+    const auto i = static_cast<size_t>(table);
+    files_[i].write(buffers_[i].data(), buffers_[i].size());
+    if (!files_[i])
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                catenate("Problem writing shard file: ", (set_path_ / k_table_files[i]).string()));
+    }
+    set_bytes_ += buffers_[i].size();
+    buffers_[i].clear();
+} // -----  end of method ShardWriter::FlushTable  -----
+
+void ShardWriter::Close()
+{
+    if (!set_is_open_)
+    {
+        return;
+    }
+    set_is_open_ = false;
+
+    for (size_t i = 0; i < k_table_count; ++i)
+    {
+        FlushTable(static_cast<Table>(i));
+        files_[i].close();
+    }
+
+    // only now can a loader see it.
+
+    auto complete_path = set_path_;
+    complete_path.replace_extension();
+    fs::rename(set_path_, complete_path);
+
+    spdlog::info(catenate("Wrote shard set: ", complete_path.string(), " with: ", filing_number_, " filings, ",
+                          set_bytes_, " bytes."));
+} // -----  end of method ShardWriter::Close  -----
+
+std::string OfflineWriterName(int worker)
+{
+    std::array<char, 256> host_name{};
+    gethostname(host_name.data(), host_name.size() - 1);
+    return catenate(host_name.data(), '-', getpid(), '-', worker);
+} /* -----  end of function OfflineWriterName  ----- */
+
+std::vector<fs::path> FindShardSetsToLoad(const fs::path &directory)
+{
+    std::vector<fs::path> shard_sets;
+    for (const auto &entry : fs::directory_iterator(directory))
+    {
+        if (!entry.is_directory())
+        {
+            continue;
+        }
+        const auto extension = entry.path().extension().string();
+        if (extension == k_partial_suffix || extension == k_loaded_suffix)
+        {
+            continue;
+        }
+        shard_sets.push_back(entry.path());
+    }
+    rng::sort(shard_sets);
+    return shard_sets;
+} /* -----  end of function FindShardSetsToLoad  ----- */
+
+std::pair<int, int> LoadShardSet(const fs::path &set_path, pqxx::dbtransaction &trxn, const std::string &schema_name,
+                                 bool replace_DB_content)
+{
+    for (size_t i = 0; i < k_shard_tables.size(); ++i)
+    {
+        trxn.exec(k_shard_tables[i]);
+        CopyFileToTable(set_path / k_table_files[i], k_shard_table_names[i], trxn);
+    }
+
+    // same sec_filing_id rules as the filing_id_upsert statement, just for a whole set
+    // at once. an amended filing is the one with an amended_date_filed.
+    // the data tables are cleared for updated rows then filled from the shard tables
+    // through the local_id -> filing_id mapping.
+
+    auto load_cmd = std::format(
+        "WITH latest AS (SELECT DISTINCT ON (cik, form_type, period_ending, data_source) * FROM shard_filings"
+        " ORDER BY cik, form_type, period_ending, data_source, date_filed DESC, local_id DESC),"
+        " upserted AS ("
+        " INSERT INTO {0}.sec_filing_id AS existing"
+        " (cik, company_name, file_name, symbol, sic, form_type, date_filed, period_ending, period_context_id,"
+        " shares_outstanding, data_source, amended_file_name, amended_date_filed)"
+        " SELECT cik, company_name, CASE WHEN is_amended THEN NULL ELSE file_name END, symbol, sic, form_type,"
+        " CASE WHEN is_amended THEN NULL ELSE date_filed END, period_ending, period_context_id, shares_outstanding,"
+        " data_source, CASE WHEN is_amended THEN file_name END, CASE WHEN is_amended THEN date_filed END"
+        " FROM latest"
+        " ON CONFLICT (cik, form_type, period_ending, data_source) DO UPDATE SET"
+        " company_name = EXCLUDED.company_name, symbol = EXCLUDED.symbol, sic = EXCLUDED.sic,"
+        " period_context_id = EXCLUDED.period_context_id, shares_outstanding = EXCLUDED.shares_outstanding,"
+        " amended_file_name = COALESCE(EXCLUDED.amended_file_name, existing.amended_file_name),"
+        " amended_date_filed = COALESCE(EXCLUDED.amended_date_filed, existing.amended_date_filed)"
+        " WHERE {1} OR EXCLUDED.amended_date_filed > COALESCE(existing.amended_date_filed, DATE '1900-01-01')"
+        " RETURNING filing_id, cik, form_type, period_ending, data_source),"
+        " loaded AS (SELECT u.filing_id, l.local_id, l.is_amended, u.cik, u.form_type, u.period_ending,"
+        " u.data_source FROM upserted u JOIN latest l USING (cik, form_type, period_ending, data_source)),"
+        " other_sources AS (DELETE FROM {0}.sec_filing_id f USING loaded l"
+        " WHERE f.cik = l.cik AND f.form_type = l.form_type AND f.period_ending = l.period_ending"
+        " AND f.data_source <> l.data_source AND ({1} OR l.is_amended)),"
+        " clear_xbrl AS (DELETE FROM {0}.sec_xbrl_data WHERE filing_id IN (SELECT filing_id FROM upserted)),"
+        " clear_bal_sheet AS (DELETE FROM {0}.sec_bal_sheet_data WHERE filing_id IN (SELECT filing_id FROM upserted)),"
+        " clear_stmt_of_ops AS (DELETE FROM {0}.sec_stmt_of_ops_data"
+        " WHERE filing_id IN (SELECT filing_id FROM upserted)),"
+        " clear_cash_flows AS (DELETE FROM {0}.sec_cash_flows_data"
+        " WHERE filing_id IN (SELECT filing_id FROM upserted)),"
+        " xbrl AS (INSERT INTO {0}.sec_xbrl_data"
+        " (filing_id, xbrl_label, label, value, context_id, period_begin, period_end, units, decimals)"
+        " SELECT l.filing_id, d.xbrl_label, d.label, d.value, d.context_id, d.period_begin, d.period_end, d.units,"
+        " d.decimals FROM shard_xbrl_data d JOIN loaded l USING (local_id)),"
+        " bal_sheet AS (INSERT INTO {0}.sec_bal_sheet_data (filing_id, label, value)"
+        " SELECT l.filing_id, d.label, d.value FROM shard_bal_sheet_data d JOIN loaded l USING (local_id)),"
+        " stmt_of_ops AS (INSERT INTO {0}.sec_stmt_of_ops_data (filing_id, label, value)"
+        " SELECT l.filing_id, d.label, d.value FROM shard_stmt_of_ops_data d JOIN loaded l USING (local_id)),"
+        " cash_flows AS (INSERT INTO {0}.sec_cash_flows_data (filing_id, label, value)"
+        " SELECT l.filing_id, d.label, d.value FROM shard_cash_flows_data d JOIN loaded l USING (local_id))"
+        " SELECT (SELECT count(*) FROM shard_filings), (SELECT count(*) FROM upserted)",
+        schema_name, replace_DB_content ? "TRUE" : "FALSE");
+
+    auto [filings, stored] = trxn.query1<int, int>(load_cmd);
+    return {filings, stored};
+} /* -----  end of function LoadShardSet  ----- */
+
+void MarkShardSetLoaded(const fs::path &set_path)
+{
+    auto loaded_path = set_path;
+    loaded_path += k_loaded_suffix;
+    fs::rename(set_path, loaded_path);
+} /* -----  end of function MarkShardSetLoaded  ----- */
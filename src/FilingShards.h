@@ -0,0 +1,151 @@
+// =====================================================================================
+//
+//       Filename:  FilingShards.h
+//
+//    Description:  Write extracted filings to COPY-ready shard files and load
+//                  them into the DB later.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 04:06:52 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+// a shard set is a directory holding 1 COPY text file per table. every row
+// starts with a filing number which is only good within its set. the filings
+// file has the sec_filing_id fields, the others the data rows.
+// sets are written under a '.partial' name and renamed once complete. a set
+// which has been loaded is renamed with '.loaded'.
+
+#ifndef FILINGSHARDS_H_
+#define FILINGSHARDS_H_
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pqxx/pqxx>
+
+#include "CopyTextWriter.h"
+#include "Extractor_Utils.h"
+
+// =====================================================================================
+//        Class:  ShardWriter
+//  Description:  Writes shard sets for 1 worker. A new set is started once the
+//                current one reaches max_set_bytes but a filing's rows always
+//                stay in 1 set.
+//
+//                Not thread safe. Each worker needs its own.
+// =====================================================================================
+
+class ShardWriter
+{
+public:
+    enum class Table : int
+    {
+        e_filings = 0,
+        e_xbrl_data,
+        e_bal_sheet_data,
+        e_stmt_of_ops_data,
+        e_cash_flows_data,
+        e_count
+    };
+
+    // ====================  LIFECYCLE     =======================================
+
+    ShardWriter(const fs::path &directory, int worker, size_t max_set_bytes);
+    ShardWriter(const ShardWriter &rhs) = delete;
+    ShardWriter(ShardWriter &&rhs) = delete;
+
+    ~ShardWriter();
+
+    // ====================  MUTATORS      =======================================
+
+    // starts a new filing. the data rows which follow belong to it.
+    // a filing's rows are only written out once the next filing starts so
+    // one which fails part way through can be dropped.
+
+    void AddFiling(const FilingIDValues &values);
+    void DropFiling();
+
+    template <typename... Fields> void AddRow(Table table, const Fields &...fields)
+    {
+        auto &buffer = buffers_[static_cast<int>(table)];
+        AppendCopyRow(buffer, filing_number_, fields...);
+        buffer += '\n';
+    }
+
+    void Close();
+
+    // ====================  OPERATORS     =======================================
+
+    ShardWriter &operator=(const ShardWriter &rhs) = delete;
+    ShardWriter &operator=(ShardWriter &&rhs) = delete;
+
+private:
+    static constexpr size_t k_flush_size{256 * 1024};
+    static constexpr auto k_table_count = static_cast<size_t>(Table::e_count);
+
+    void OpenSet();
+    void FlushTable(Table table);
+
+    // ====================  DATA MEMBERS  =======================================
+
+    fs::path directory_;
+    std::string writer_name_;
+    size_t max_set_bytes_;
+
+    fs::path set_path_;
+    std::array<std::ofstream, k_table_count> files_;
+    std::array<std::string, k_table_count> buffers_;
+    std::array<size_t, k_table_count> filing_starts_{};
+    size_t set_bytes_{0};
+    int set_number_{0};
+    int64_t filing_number_{0};
+    bool set_is_open_{false};
+
+}; // -----  end of class ShardWriter  -----
+
+// host, process and worker. keeps file names from different writers apart
+// when they share a directory.
+
+std::string OfflineWriterName(int worker);
+
+// complete shard sets in directory which have not been loaded yet.
+
+std::vector<fs::path> FindShardSetsToLoad(const fs::path &directory);
+
+// loads 1 set inside the caller's transaction. sec_filing_id rows follow the same
+// rules as UpsertFilingID. if a set has more than 1 filing for the same key, the
+// latest filed one is used.
+// returns the number of filings in the set and how many were stored.
+
+std::pair<int, int> LoadShardSet(const fs::path &set_path, pqxx::dbtransaction &trxn, const std::string &schema_name,
+                                 bool replace_DB_content);
+
+void MarkShardSetLoaded(const fs::path &set_path);
+
+#endif /* FILINGSHARDS_H_ */
@@ -0,0 +1,167 @@
+// =====================================================================================
+//
+//       Filename:  GroupCommitWriter.cpp
+//
+//    Description:  Collects filings from a store worker and commits them to the
+//                  DB in batches.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 09:12:41 AM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "GroupCommitWriter.h"
+
+#include <algorithm>
+#include <mutex>
+
+GroupCommitWriter::GroupCommitWriter(DatabasePool *db_pool, ExtractMutex *active_forms, size_t max_rows,
+                                     std::chrono::milliseconds max_latency)
+    : db_pool_{db_pool}, active_forms_{active_forms}, max_rows_{max_rows}, max_latency_{max_latency}
+{
+} // -----  end of method GroupCommitWriter::GroupCommitWriter  (constructor)  -----
+
+GroupCommitWriter::~GroupCommitWriter()
+{
+    // Flush reports commit problems through the done functions so there
+    // is nothing left to throw here.
+
+    Flush();
+} // -----  end of method GroupCommitWriter::~GroupCommitWriter  -----
+
+std::chrono::milliseconds GroupCommitWriter::TimeLeft() const
+{
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                         batch_started_);
+    return std::max(max_latency_ - waited, std::chrono::milliseconds{0});
+} // -----  end of method GroupCommitWriter::TimeLeft  -----
+
+void GroupCommitWriter::Add(const std::string &lock_id, size_t rows, const WriteFunction &write, DoneFunction done)
+{
+    std::unique_ptr<ExtractLock> lock;
+    if (active_forms_ != nullptr)
+    {
+        lock = std::make_unique<ExtractLock>(active_forms_, lock_id, std::try_to_lock);
+        if (!lock->owns_lock())
+        {
+            Flush();
+            lock = std::make_unique<ExtractLock>(active_forms_, lock_id);
+        }
+    }
+
+    bool did_load{false};
+    try
+    {
+        if (!trxn_)
+        {
+            conn_.emplace(db_pool_->get_connection());
+            trxn_ = std::make_unique<pqxx::work>(**conn_);
+            batch_started_ = std::chrono::steady_clock::now();
+        }
+
+        // if this filing fails, only its own work is rolled back.
+
+        pqxx::subtransaction filing_trxn{*trxn_, "filing"};
+        did_load = write(filing_trxn);
+        filing_trxn.commit();
+    }
+    catch (...)
+    {
+        DropEmptyBatch();
+        done(false, std::current_exception());
+        return;
+    }
+
+    if (!did_load)
+    {
+        DropEmptyBatch();
+        done(false, nullptr);
+        return;
+    }
+
+    pending_.emplace_back(std::move(lock), std::move(done));
+    rows_ += rows;
+
+    if (rows_ >= max_rows_ || TimeLeft() == std::chrono::milliseconds{0})
+    {
+        Flush();
+    }
+} // -----  end of method GroupCommitWriter::Add  -----
+
+void GroupCommitWriter::Flush()
+{
+    if (!trxn_)
+    {
+        return;
+    }
+
+    std::exception_ptr error{nullptr};
+    try
+    {
+        trxn_->commit();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    trxn_.reset();
+    conn_.reset();
+    rows_ = 0;
+
+    // let go of the locks before telling anyone how things went.
+
+    auto committed = std::move(pending_);
+    pending_.clear();
+    for (auto &filing : committed)
+    {
+        filing.lock_.reset();
+    }
+    for (auto &filing : committed)
+    {
+        filing.done_(error == nullptr, error);
+    }
+} // -----  end of method GroupCommitWriter::Flush  -----
+
+void GroupCommitWriter::DropEmptyBatch()
+{
+    // a filing which failed or was skipped may still have left locks behind in the
+    // transaction (the upsert mode locks the row it declined to update). if nothing
+    // else is waiting on the commit, let go of the transaction and the connection
+    // now rather than sit idle in a transaction until the next filing shows up.
+
+    if (!pending_.empty() || !trxn_)
+    {
+        return;
+    }
+    try
+    {
+        trxn_->abort();
+    }
+    catch (const std::exception &)
+    {
+        // the connection is going back to the pool either way.
+    }
+    trxn_.reset();
+    conn_.reset();
+    rows_ = 0;
+} // -----  end of method GroupCommitWriter::DropEmptyBatch  -----
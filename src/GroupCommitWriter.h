@@ -0,0 +1,129 @@
+// =====================================================================================
+//
+//       Filename:  GroupCommitWriter.h
+//
+//    Description:  Collects filings from a store worker and commits them to the
+//                  DB in batches.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 09:12:41 AM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+// =====================================================================================
+//        Class:  GroupCommitWriter
+//  Description:  Each filing is written inside its own savepoint as soon as it
+//                is added so a failure only loses that filing. The enclosing
+//                transaction is committed once the batch has enough rows or
+//                has been open long enough. Results are only reported after
+//                the commit.
+//
+//                Per-filing locks are held until the commit. If a filing is
+//                locked elsewhere, we commit what we have before waiting so
+//                we never wait while holding locks of our own.
+//
+//                One writer per thread. It is not thread safe.
+// =====================================================================================
+
+#ifndef GROUPCOMMITWRITER_H_
+#define GROUPCOMMITWRITER_H_
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <pqxx/pqxx>
+
+#include "DatabasePool.h"
+#include "ExtractorMutexAndLock.h"
+
+class GroupCommitWriter
+{
+public:
+    // write returns false if it decided there was nothing to store.
+    // done is told whether the filing was stored or why not.
+
+    using WriteFunction = std::function<bool(pqxx::dbtransaction &)>;
+    using DoneFunction = std::function<void(bool, std::exception_ptr)>;
+
+    // ====================  LIFECYCLE     =======================================
+
+    GroupCommitWriter(DatabasePool *db_pool, ExtractMutex *active_forms, size_t max_rows,
+                      std::chrono::milliseconds max_latency);
+    GroupCommitWriter(const GroupCommitWriter &rhs) = delete;
+    GroupCommitWriter(GroupCommitWriter &&rhs) = delete;
+
+    ~GroupCommitWriter();
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] bool empty() const
+    {
+        return pending_.empty();
+    }
+
+    // how much longer the current batch can wait for more filings.
+
+    [[nodiscard]] std::chrono::milliseconds TimeLeft() const;
+
+    // ====================  MUTATORS      =======================================
+
+    void Add(const std::string &lock_id, size_t rows, const WriteFunction &write, DoneFunction done);
+    void Flush();
+
+    // ====================  OPERATORS     =======================================
+
+    GroupCommitWriter &operator=(const GroupCommitWriter &rhs) = delete;
+    GroupCommitWriter &operator=(GroupCommitWriter &&rhs) = delete;
+
+private:
+    struct PendingFiling
+    {
+        std::unique_ptr<ExtractLock> lock_;
+        DoneFunction done_;
+    };
+
+    // rolls back and releases the transaction when no filings are waiting on it.
+
+    void DropEmptyBatch();
+
+    // ====================  DATA MEMBERS  =======================================
+
+    DatabasePool *db_pool_;
+    ExtractMutex *active_forms_;
+    size_t max_rows_;
+    std::chrono::milliseconds max_latency_;
+
+    std::optional<PooledConnection> conn_;
+    std::unique_ptr<pqxx::work> trxn_;
+    std::vector<PendingFiling> pending_;
+    size_t rows_{0};
+    std::chrono::steady_clock::time_point batch_started_;
+
+}; // -----  end of class GroupCommitWriter  -----
+
+#endif /* GROUPCOMMITWRITER_H_ */
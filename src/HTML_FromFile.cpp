@@ -88,8 +88,8 @@ HTML_FromFile::html_itor::html_itor(EM::DocumentSectionList const *document_sect
         if (!html_info_.html_.get().empty())
         {
             html_info_.document_ = (*document_sections_)[current_doc_];
-            html_info_.file_name_ = FindFileName((*document_sections_)[current_doc_], document_name_);
-            html_info_.file_type_ = FindFileType((*document_sections_)[current_doc_]);
+            html_info_.file_name_ = EM::FileName{std::filesystem::path{html_info_.document_.file_name_}};
+            html_info_.file_type_ = EM::FileType{html_info_.document_.type_};
             return;
         }
     }
@@ -104,8 +104,8 @@ HTML_FromFile::html_itor &HTML_FromFile::html_itor::operator++()
         if (!html_info_.html_.get().empty())
         {
             html_info_.document_ = (*document_sections_)[current_doc_];
-            html_info_.file_name_ = FindFileName((*document_sections_)[current_doc_], document_name_);
-            html_info_.file_type_ = FindFileType((*document_sections_)[current_doc_]);
+            html_info_.file_name_ = EM::FileName{std::filesystem::path{html_info_.document_.file_name_}};
+            html_info_.file_type_ = EM::FileType{html_info_.document_.type_};
             return *this;
         }
     }
@@ -31,17 +31,81 @@
 /* You should have received a copy of the GNU General Public License */
 /* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
 
+#include <algorithm>
+#include <array>
+#include <cctype>
 #include <iostream>
+#include <iterator>
 #include <ranges>
+#include <utility>
 
 #include "SEC_Header.h"
 
-#include <boost/regex.hpp>
+#include <boost/assert.hpp>
 
 namespace rng = std::ranges;
 
 #include "Extractor_Utils.h"
 
+namespace
+{
+// header lines look like: '<optional indent>LABEL:<whitespace>value'
+// we record the first occurrence of each label we care about. for filings
+// with more than 1 filer, that's the first filer which is what we want.
+
+using RecordField = EM::sv SEC_HeaderRecord::*;
+
+constexpr std::array<std::pair<EM::sv, RecordField>, 7> k_header_labels{{
+    {"ACCESSION NUMBER:", &SEC_HeaderRecord::accession_number_},
+    {"CONFORMED SUBMISSION TYPE:", &SEC_HeaderRecord::submission_type_},
+    {"CONFORMED PERIOD OF REPORT:", &SEC_HeaderRecord::quarter_ending_text_},
+    {"FILED AS OF DATE:", &SEC_HeaderRecord::date_filed_text_},
+    {"COMPANY CONFORMED NAME:", &SEC_HeaderRecord::company_name_},
+    {"CENTRAL INDEX KEY:", &SEC_HeaderRecord::cik_},
+    {"STANDARD INDUSTRIAL CLASSIFICATION:", &SEC_HeaderRecord::sic_},
+}};
+
+constexpr EM::sv k_whitespace{" \t\r"};
+
+EM::sv TrimWhitespace(EM::sv text)
+{
+    const auto first = text.find_first_not_of(k_whitespace);
+    if (first == EM::sv::npos)
+    {
+        return {};
+    }
+    const auto last = text.find_last_not_of(k_whitespace);
+    return text.substr(first, last - first + 1);
+}
+
+bool AllDigits(EM::sv text)
+{
+    return !text.empty() && rng::all_of(text, [](unsigned char c) { return std::isdigit(c); });
+}
+
+// header dates are always 'YYYYMMDD'. from_stream is much more than we need here.
+
+std::chrono::year_month_day ParseHeaderDate(EM::sv the_date, const char *message)
+{
+    BOOST_ASSERT_MSG(the_date.size() == 8 && AllDigits(the_date), message);
+
+    auto digits = [the_date](int from, int count) {
+        int result{0};
+        for (int i = from; i < from + count; ++i)
+        {
+            result = result * 10 + (the_date[i] - '0');
+        }
+        return result;
+    };
+
+    std::chrono::year_month_day result{std::chrono::year{digits(0, 4)},
+                                       std::chrono::month{static_cast<unsigned>(digits(4, 2))},
+                                       std::chrono::day{static_cast<unsigned>(digits(6, 2))}};
+    BOOST_ASSERT_MSG(result.ok(), catenate("Invalid date: ", the_date).c_str());
+    return result;
+}
+} // namespace
+
 //--------------------------------------------------------------------------------------
 //       Class:  SEC_Header
 //      Method:  SEC_Header
@@ -50,137 +114,104 @@ namespace rng = std::ranges;
 
 void SEC_Header::UseData(EM::FileContent file_content)
 {
-    const boost::regex regex_SEC_header{R"***(^<SEC-HEADER>.+?</SEC-HEADER>$)***"};
-    boost::cmatch results;
+    static constexpr EM::sv header_begin{"<SEC-HEADER>"};
+    static constexpr EM::sv header_end{"</SEC-HEADER>"};
 
-    bool found_it =
-        boost::regex_search(file_content.get().cbegin(), file_content.get().cend(), results, regex_SEC_header);
-    BOOST_ASSERT_MSG(found_it, "Can't find SEC Header");
+    const EM::sv content{file_content.get()};
 
-    header_data_ = EM::sv(results[0].first, results[0].length());
+    const auto begin = content.find(header_begin);
+    const auto end = begin == EM::sv::npos ? EM::sv::npos : content.find(header_end, begin + header_begin.size());
+    BOOST_ASSERT_MSG(end != EM::sv::npos, "Can't find SEC Header");
+
+    header_data_ = content.substr(begin, end + header_end.size() - begin);
 } // -----  end of method SEC_Header::UseData  -----
 
 void SEC_Header::ExtractHeaderFields()
 {
-    ExtractAccessionNunber();
-    ExtractCIK();
-    ExtractSIC();
-    ExtractFormType();
-    ExtractDateFiled();
-    ExtractQuarterEnding();
-    ExtractFileName();
-    ExtractCompanyName();
+    ScanHeaderFields();
+    ValidateHeaderFields();
+    BuildFieldsMap();
 } // -----  end of method SEC_Header::ExtractHeaderFields  -----
 
-void SEC_Header::ExtractAccessionNunber()
-{
-    const boost::regex ex{R"***(^ACCESSION NUMBER:\s+([0-9-]+?)$)***"};
-
-    boost::cmatch results;
-    bool found_it = boost::regex_search(header_data_.cbegin(), header_data_.cend(), results, ex);
-
-    BOOST_ASSERT_MSG(found_it, "Can't find 'acceession number' in SEC Header");
-
-    parsed_header_data_["accession_number"] = results.str(1);
-} // -----  end of method SEC_Header::ExtractFileName  -----
-
-void SEC_Header::ExtractCIK()
+void SEC_Header::ScanHeaderFields()
 {
-    const boost::regex ex{R"***(^\s+CENTRAL INDEX KEY:\s+([0-9]+$))***"};
-
-    boost::cmatch results;
-    bool found_it = boost::regex_search(header_data_.cbegin(), header_data_.cend(), results, ex);
+    header_record_ = {};
 
-    BOOST_ASSERT_MSG(found_it, "Can't find CIK in SEC Header");
+    size_t fields_found{0};
+    EM::sv remaining{header_data_};
 
-    parsed_header_data_["cik"] = results.str(1);
-} // -----  end of method SEC_Header::ExtractCIK  -----
+    while (!remaining.empty() && fields_found < k_header_labels.size())
+    {
+        const auto eol = remaining.find('\n');
+        const EM::sv line = TrimWhitespace(remaining.substr(0, eol));
+        remaining.remove_prefix(eol == EM::sv::npos ? remaining.size() : eol + 1);
+
+        for (const auto &[label, field] : k_header_labels)
+        {
+            if (line.starts_with(label))
+            {
+                if ((header_record_.*field).empty())
+                {
+                    header_record_.*field = TrimWhitespace(line.substr(label.size()));
+                    fields_found += (header_record_.*field).empty() ? 0 : 1;
+                }
+                break;
+            }
+        }
+    }
+} // -----  end of method SEC_Header::ScanHeaderFields  -----
 
-void SEC_Header::ExtractSIC()
+void SEC_Header::ValidateHeaderFields()
 {
-    // this field is sometimes missing in my test files.  I can live without it.
+    BOOST_ASSERT_MSG(!header_record_.accession_number_.empty() &&
+                         rng::all_of(header_record_.accession_number_,
+                                     [](unsigned char c) { return std::isdigit(c) || c == '-'; }),
+                     "Can't find 'acceession number' in SEC Header");
 
-    const boost::regex ex{R"***(^\s+STANDARD INDUSTRIAL CLASSIFICATION:.+?\[?([0-9]+)\]?)***"};
+    BOOST_ASSERT_MSG(AllDigits(header_record_.cik_), "Can't find CIK in SEC Header");
 
-    boost::cmatch results;
-    bool found_it = boost::regex_search(header_data_.cbegin(), header_data_.cend(), results, ex);
+    // SIC is sometimes missing in my test files.  I can live without it.
+    // the value looks like: 'SERVICES-PREPACKAGED SOFTWARE [7372]'
 
-    if (found_it)
+    const auto sic_begin = header_record_.sic_.find_first_of("0123456789");
+    if (sic_begin != EM::sv::npos)
     {
-        parsed_header_data_["sic"] = results.str(1);
+        const auto sic_end = header_record_.sic_.find_first_not_of("0123456789", sic_begin);
+        header_record_.sic_ = header_record_.sic_.substr(sic_begin, sic_end - sic_begin);
     }
     else
     {
-        parsed_header_data_["sic"] = "unknown";
+        header_record_.sic_ = {};
     }
-} // -----  end of method SEC_Header::ExtractSIC  -----
-
-void SEC_Header::ExtractFormType()
-{
-    const boost::regex ex{R"***(^CONFORMED SUBMISSION TYPE:\s+(.+?)$)***",
-                          boost::regex_constants::match_not_dot_newline};
-
-    boost::cmatch results;
-    bool found_it = boost::regex_search(header_data_.cbegin(), header_data_.cend(), results, ex);
 
-    BOOST_ASSERT_MSG(found_it, "Can't find 'form type' in SEC Header");
+    BOOST_ASSERT_MSG(!header_record_.submission_type_.empty(), "Can't find 'form type' in SEC Header");
 
     // since we use form type as part of our file name for forms stored on disk,
     // we can't have the '/' character in it.  Our Collect program replaces the
     // '/' with '_' so we do the same here.
 
-    parsed_header_data_["form_type"] = {};
-    rng::transform(results.str(1), std::back_inserter(parsed_header_data_["form_type"]),
+    header_record_.form_type_.reserve(header_record_.submission_type_.size());
+    rng::transform(header_record_.submission_type_, std::back_inserter(header_record_.form_type_),
                    [](unsigned char c) { return (c == '/' ? '_' : std::toupper(c)); });
-} // -----  end of method SEC_Header::ExtractFormNumber  -----
 
-void SEC_Header::ExtractDateFiled()
-{
-    const boost::regex ex{R"***(^FILED AS OF DATE:\s+([0-9]+?)$)***"};
+    header_record_.date_filed_ =
+        ParseHeaderDate(header_record_.date_filed_text_, "Can't find 'date filed' in SEC Header");
+    header_record_.quarter_ending_ =
+        ParseHeaderDate(header_record_.quarter_ending_text_, "Can't find 'quarter ending' in SEC Header");
 
-    boost::cmatch results;
-    bool found_it = boost::regex_search(header_data_.cbegin(), header_data_.cend(), results, ex);
+    BOOST_ASSERT_MSG(!header_record_.company_name_.empty(), "Can't find 'company name' in SEC Header");
+} // -----  end of method SEC_Header::ValidateHeaderFields  -----
 
-    BOOST_ASSERT_MSG(found_it, "Can't find 'date filed' in SEC Header");
-
-    auto the_date = StringToDateYMD("%Y%m%d", results.str(1));
-    parsed_header_data_["date_filed"] = std::format("{:%F}", the_date);
-} // -----  end of method SEC_Header::ExtractDateFiled  -----
-
-void SEC_Header::ExtractQuarterEnding()
+void SEC_Header::BuildFieldsMap()
 {
-    const boost::regex ex{R"***(^CONFORMED PERIOD OF REPORT:\s+([0-9]+?)$)***"};
-
-    boost::cmatch results;
-    bool found_it = boost::regex_search(header_data_.cbegin(), header_data_.cend(), results, ex);
-
-    BOOST_ASSERT_MSG(found_it, "Can't find 'quarter ending' in SEC Header");
-
-    auto the_date = StringToDateYMD("%Y%m%d", results.str(1));
-    parsed_header_data_["quarter_ending"] = std::format("{:%F}", the_date);
-} // -----  end of method SEC_Header::ExtractQuarterEnded  -----
-
-void SEC_Header::ExtractFileName()
-{
-    const boost::regex ex{R"***(^ACCESSION NUMBER:\s+([0-9-]+?)$)***"};
-
-    boost::cmatch results;
-    bool found_it = boost::regex_search(header_data_.cbegin(), header_data_.cend(), results, ex);
-
-    BOOST_ASSERT_MSG(found_it, "Can't find 'file name' in SEC Header");
-
-    parsed_header_data_["file_name"] = results.str(1) + ".txt";
-} // -----  end of method SEC_Header::ExtractFileName  -----
-
-void SEC_Header::ExtractCompanyName()
-{
-    const boost::regex ex{R"***(^\s+COMPANY CONFORMED NAME:\s+(.+?)$)***",
-                          boost::regex_constants::match_not_dot_newline};
-
-    boost::cmatch results;
-    bool found_it = boost::regex_search(header_data_.cbegin(), header_data_.cend(), results, ex);
-
-    BOOST_ASSERT_MSG(found_it, "Can't find 'company name' in SEC Header");
-
-    parsed_header_data_["company_name"] = results.str(1);
-} // -----  end of method SEC_Header::ExtractCompanyName  -----
+    parsed_header_data_.clear();
+
+    parsed_header_data_["accession_number"] = header_record_.accession_number_;
+    parsed_header_data_["cik"] = header_record_.cik_;
+    parsed_header_data_["sic"] = header_record_.sic_.empty() ? EM::sv{"unknown"} : header_record_.sic_;
+    parsed_header_data_["form_type"] = header_record_.form_type_;
+    parsed_header_data_["date_filed"] = std::format("{:%F}", header_record_.date_filed_);
+    parsed_header_data_["quarter_ending"] = std::format("{:%F}", header_record_.quarter_ending_);
+    parsed_header_data_["file_name"] = catenate(header_record_.accession_number_, ".txt");
+    parsed_header_data_["company_name"] = header_record_.company_name_;
+} // -----  end of method SEC_Header::BuildFieldsMap  -----
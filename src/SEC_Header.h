@@ -38,8 +38,29 @@
 #ifndef _SEC_HEADER_INC_
 #define _SEC_HEADER_INC_
 
+#include <chrono>
+#include <string>
+
 #include "Extractor.h"
 
+// the fields we pull from the header. the views point into the content
+// which was given to UseData when ExtractHeaderFields was called.
+
+struct SEC_HeaderRecord
+{
+    EM::sv accession_number_;
+    EM::sv cik_;
+    EM::sv sic_;             // empty if not in header
+    EM::sv submission_type_; // as it appears in the header
+    EM::sv company_name_;
+    EM::sv date_filed_text_;
+    EM::sv quarter_ending_text_;
+
+    std::string form_type_; // submission type cleaned up for use in file names
+    std::chrono::year_month_day date_filed_;
+    std::chrono::year_month_day quarter_ending_;
+};
+
 class SEC_Header
 {
 public:
@@ -53,6 +74,10 @@ public:
     {
         return parsed_header_data_;
     }
+    [[nodiscard]] const SEC_HeaderRecord &GetRecord() const
+    {
+        return header_record_;
+    }
     [[nodiscard]] EM::sv GetHeader(void) const
     {
         return header_data_;
@@ -66,14 +91,9 @@ public:
     // ====================  OPERATORS     =======================================
 
 protected:
-    void ExtractAccessionNunber();
-    void ExtractCIK();
-    void ExtractSIC();
-    void ExtractFormType();
-    void ExtractDateFiled();
-    void ExtractQuarterEnding();
-    void ExtractFileName();
-    void ExtractCompanyName();
+    void ScanHeaderFields();
+    void ValidateHeaderFields();
+    void BuildFieldsMap();
 
     // ====================  DATA MEMBERS  =======================================
 
@@ -82,6 +102,10 @@ private:
 
     EM::sv header_data_;
 
+    SEC_HeaderRecord header_record_;
+
+    // kept for existing code which looks up fields by name.
+
     EM::SEC_Header_fields parsed_header_data_;
 
 }; // -----  end of class SEC_Header  -----
@@ -0,0 +1,195 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  SectionScanner.cpp
+ *
+ *    Description:  Find the SGML markers which divide an SEC filing into
+ *                  document sections in a single pass over the file.
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 09:12:40 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  David P. Riedel (), driedel@cox.net
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "SectionScanner.h"
+
+#include <array>
+#include <bit>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SECTION_SCANNER_X86
+#endif
+
+// every marker begins with '<' and has its closing '>' at one of 4 offsets
+// from there.  we use that to weed out the many other tags in a filing
+// (HTML, XBRL) before doing any string compares.
+//
+//  <TYPE>  <TEXT>          '>' at 5
+//  </TEXT>                 '>' at 6
+//  <DOCUMENT>  <FILENAME>  '>' at 9
+//  </DOCUMENT>             '>' at 10
+
+namespace
+{
+constexpr std::array<std::pair<EM::sv, SectionMarker>, 6> k_markers{{
+    {"<DOCUMENT>", SectionMarker::e_DocumentBegin},
+    {"</DOCUMENT>", SectionMarker::e_DocumentEnd},
+    {"<TYPE>", SectionMarker::e_Type},
+    {"<FILENAME>", SectionMarker::e_FileName},
+    {"<TEXT>", SectionMarker::e_TextBegin},
+    {"</TEXT>", SectionMarker::e_TextEnd},
+}};
+
+constexpr size_t k_max_close_offset{10};
+
+inline void CheckCandidate(EM::sv content, size_t offset, SectionMarkerList &markers)
+{
+    const auto candidate = content.substr(offset);
+    for (const auto &[tag, marker] : k_markers)
+    {
+        if (candidate.starts_with(tag))
+        {
+            markers.push_back({offset, tag.size(), marker});
+            return;
+        }
+    }
+}
+
+void ScanScalar(EM::sv content, size_t from, SectionMarkerList &markers)
+{
+    for (auto pos = content.find('<', from); pos != EM::sv::npos; pos = content.find('<', pos + 1))
+    {
+        CheckCandidate(content, pos, markers);
+    }
+}
+
+#ifdef SECTION_SCANNER_X86
+
+__attribute__((target("sse2"))) inline __m128i ClosesAt(const char *pos, __m128i close)
+{
+    return _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos)), close);
+}
+
+__attribute__((target("sse2"))) void ScanSSE2(EM::sv content, SectionMarkerList &markers)
+{
+    const char *data = content.data();
+    const __m128i open = _mm_set1_epi8('<');
+    const __m128i close = _mm_set1_epi8('>');
+
+    size_t i{0};
+    for (; i + sizeof(__m128i) + k_max_close_offset <= content.size(); i += sizeof(__m128i))
+    {
+        const auto opens =
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), open);
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(opens));
+        if (mask == 0)
+        {
+            continue;
+        }
+        const auto closes = _mm_or_si128(_mm_or_si128(ClosesAt(data + i + 5, close), ClosesAt(data + i + 6, close)),
+                                         _mm_or_si128(ClosesAt(data + i + 9, close), ClosesAt(data + i + 10, close)));
+        mask &= static_cast<uint32_t>(_mm_movemask_epi8(closes));
+
+        while (mask != 0)
+        {
+            CheckCandidate(content, i + std::countr_zero(mask), markers);
+            mask &= mask - 1;
+        }
+    }
+    ScanScalar(content, i, markers);
+}
+
+__attribute__((target("avx2"))) inline __m256i ClosesAt(const char *pos, __m256i close)
+{
+    return _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos)), close);
+}
+
+__attribute__((target("avx2"))) void ScanAVX2(EM::sv content, SectionMarkerList &markers)
+{
+    const char *data = content.data();
+    const __m256i open = _mm256_set1_epi8('<');
+    const __m256i close = _mm256_set1_epi8('>');
+
+    size_t i{0};
+    for (; i + sizeof(__m256i) + k_max_close_offset <= content.size(); i += sizeof(__m256i))
+    {
+        const auto opens =
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), open);
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(opens));
+        if (mask == 0)
+        {
+            continue;
+        }
+        const auto closes =
+            _mm256_or_si256(_mm256_or_si256(ClosesAt(data + i + 5, close), ClosesAt(data + i + 6, close)),
+                            _mm256_or_si256(ClosesAt(data + i + 9, close), ClosesAt(data + i + 10, close)));
+        mask &= static_cast<uint32_t>(_mm256_movemask_epi8(closes));
+
+        while (mask != 0)
+        {
+            CheckCandidate(content, i + std::countr_zero(mask), markers);
+            mask &= mask - 1;
+        }
+    }
+    ScanScalar(content, i, markers);
+}
+
+#endif /* SECTION_SCANNER_X86 */
+
+using ScanFunction = void (*)(EM::sv, SectionMarkerList &);
+
+ScanFunction ChooseScanner()
+{
+#ifdef SECTION_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return ScanAVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return ScanSSE2;
+    }
+#endif
+    return [](EM::sv content, SectionMarkerList &markers) { ScanScalar(content, 0, markers); };
+}
+} // namespace
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  FindSectionMarkers
+ *  Description:  the scanner is picked once, the first time we're called.
+ * =====================================================================================
+ */
+SectionMarkerList FindSectionMarkers(EM::sv content)
+{
+    static const ScanFunction scanner = ChooseScanner();
+
+    SectionMarkerList markers;
+    markers.reserve(64);
+    scanner(content, markers);
+    return markers;
+} /* -----  end of function FindSectionMarkers  ----- */
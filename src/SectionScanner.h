@@ -0,0 +1,68 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  SectionScanner.h
+ *
+ *    Description:  Find the SGML markers which divide an SEC filing into
+ *                  document sections in a single pass over the file.
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 09:12:40 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  David P. Riedel (), driedel@cox.net
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _SECTIONSCANNER_INC_
+#define _SECTIONSCANNER_INC_
+
+#include <cstdint>
+#include <vector>
+
+#include "Extractor.h"
+
+enum class SectionMarker : uint8_t
+{
+    e_DocumentBegin, // <DOCUMENT>
+    e_DocumentEnd,   // </DOCUMENT>
+    e_Type,          // <TYPE>
+    e_FileName,      // <FILENAME>
+    e_TextBegin,     // <TEXT>
+    e_TextEnd        // </TEXT>
+};
+
+struct SectionMarkerPosition
+{
+    size_t offset_; // offset of the '<'
+    size_t length_; // length of the tag
+    SectionMarker marker_;
+};
+
+using SectionMarkerList = std::vector<SectionMarkerPosition>;
+
+// returns every marker in the content in the order found.
+// uses AVX2 or SSE2 when the CPU supports it. there's no checking of
+// structure here, that's up to the caller.
+
+SectionMarkerList FindSectionMarkers(EM::sv content);
+
+#endif /* ----- #ifndef _SECTIONSCANNER_INC_  ----- */
@@ -0,0 +1,298 @@
+// =====================================================================================
+//
+//       Filename:  UUDecode.cpp
+//
+//    Description:  decode the uuencoded spreadsheets embedded in EDGAR filings
+//                  without running the uudecode program.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 03:12:40 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "UUDecode.h"
+
+#include <array>
+#include <cstdint>
+
+#include "Extractor_Utils.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define UUDECODE_X86
+#endif
+
+namespace
+{
+
+// each encoded character carries 6 bits: (c - ' ') & 0x3F. so ' ' and '`' are both 0.
+// anything outside ' '..'`' maps to k_bad_char which can't come out of a good character
+// so we can OR a whole line together and check once at the end.
+
+constexpr uint8_t k_bad_char{0x80};
+
+constexpr std::array<uint8_t, 256> k_decode_table = [] {
+    std::array<uint8_t, 256> table{};
+    table.fill(k_bad_char);
+    for (int c = ' '; c <= '`'; ++c)
+    {
+        table[c] = (c - ' ') & 0x3F;
+    }
+    return table;
+}();
+
+// nearly every line is a full one: length character 'M' (45 bytes) then 60 characters.
+
+constexpr int k_full_line_bytes{45};
+constexpr int k_full_line_chars{1 + k_full_line_bytes / 3 * 4};
+
+// the length character can claim up to 63 bytes.
+
+constexpr int k_max_line_bytes{63};
+
+inline uint8_t DecodeChar(char c)
+{
+    return k_decode_table[static_cast<uint8_t>(c)];
+}
+
+// 4 characters in, 3 bytes out.
+
+inline void DecodeGroup(uint32_t a, uint32_t b, uint32_t c, uint32_t d, char *out)
+{
+    const uint32_t bits = (a << 18) | (b << 12) | (c << 6) | d;
+    out[0] = static_cast<char>(bits >> 16);
+    out[1] = static_cast<char>(bits >> 8);
+    out[2] = static_cast<char>(bits);
+}
+
+// whole groups: no bounds checks, no partial groups and 1 validity check at the end.
+
+uint8_t DecodeGroups(const char *in, char *out, int groups)
+{
+    uint8_t seen{0};
+    for (int group = 0; group < groups; ++group, in += 4, out += 3)
+    {
+        const uint8_t a = DecodeChar(in[0]);
+        const uint8_t b = DecodeChar(in[1]);
+        const uint8_t c = DecodeChar(in[2]);
+        const uint8_t d = DecodeChar(in[3]);
+        seen |= a | b | c | d;
+        DecodeGroup(a, b, c, d, out);
+    }
+    return seen;
+}
+
+uint8_t DecodeFullLineScalar(const char *in, char *out)
+{
+    return DecodeGroups(in, out, k_full_line_bytes / 3);
+}
+
+#ifdef UUDECODE_X86
+
+// 16 characters (4 groups) at a time. the vector stores write 4 bytes past the 12
+// we decode. a full line is done front to back so the next store or the scalar
+// groups at the end overwrite them and nothing is written past the line's 45 bytes.
+//
+//  chars - ' '                     6 bit values, plus anything out of range
+//  maddubs with 64, 1              a * 64 + b, c * 64 + d in each 16 bits
+//  madd with 4096, 1               the 24 bits of each group in each 32 bits
+//  shuffle                         the 3 bytes of each group, high byte first
+
+__attribute__((target("ssse3"))) inline __m128i DecodeBlock(__m128i chars, __m128i &worst)
+{
+    const auto values = _mm_sub_epi8(chars, _mm_set1_epi8(' '));
+    worst = _mm_max_epu8(worst, values);
+    const auto pairs = _mm_maddubs_epi16(_mm_and_si128(values, _mm_set1_epi8(0x3F)), _mm_set1_epi32(0x01400140));
+    const auto groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+// good characters are ' '..'`' so every value must be 64 or less.
+
+__attribute__((target("ssse3"))) inline uint8_t CheckBlocks(__m128i worst)
+{
+    const auto limit = _mm_set1_epi8(0x40);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(worst, limit), limit)) == 0xFFFF ? 0 : k_bad_char;
+}
+
+__attribute__((target("ssse3"))) uint8_t DecodeFullLineSSSE3(const char *in, char *out)
+{
+    auto worst = _mm_setzero_si128();
+    for (int block = 0; block < 3; ++block, in += 16, out += 12)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), DecodeBlock(chars, worst));
+    }
+    return CheckBlocks(worst) | DecodeGroups(in, out, 3);
+}
+
+// the first 32 characters decode in 2 lanes which then get packed together.
+
+__attribute__((target("avx2"))) uint8_t DecodeFullLineAVX2(const char *in, char *out)
+{
+    auto worst = _mm256_setzero_si256();
+    const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+    const auto values = _mm256_sub_epi8(chars, _mm256_set1_epi8(' '));
+    worst = _mm256_max_epu8(worst, values);
+    const auto pairs =
+        _mm256_maddubs_epi16(_mm256_and_si256(values, _mm256_set1_epi8(0x3F)), _mm256_set1_epi32(0x01400140));
+    const auto groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    const auto bytes = _mm256_shuffle_epi8(
+        groups, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                 14, 13, 12, -1, -1, -1, -1));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out),
+                        _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7)));
+
+    auto worst_block = _mm_max_epu8(_mm256_castsi256_si128(worst), _mm256_extracti128_si256(worst, 1));
+    const auto chars_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 32));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 24), DecodeBlock(chars_block, worst_block));
+
+    return CheckBlocks(worst_block) | DecodeGroups(in + 48, out + 36, 3);
+}
+
+#endif /* UUDECODE_X86 */
+
+// full lines: 60 characters to 45 bytes.
+
+using FullLineFunction = uint8_t (*)(const char *, char *);
+
+FullLineFunction ChooseFullLineDecoder()
+{
+#ifdef UUDECODE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return DecodeFullLineAVX2;
+    }
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        return DecodeFullLineSSSE3;
+    }
+#endif
+    return DecodeFullLineScalar;
+}
+
+// everything else: the last line of the file, odd encoders and lines which lost their
+// trailing blanks. characters past the end of the line count as blanks.
+
+uint8_t DecodeLine(std::string_view data, int bytes, char *out)
+{
+    auto char_at = [data](size_t i) -> uint8_t { return i < data.size() ? DecodeChar(data[i]) : 0; };
+
+    uint8_t seen{0};
+    std::array<char, 3> group_bytes{};
+    for (size_t i = 0; bytes > 0; i += 4, bytes -= 3)
+    {
+        const uint8_t a = char_at(i);
+        const uint8_t b = char_at(i + 1);
+        const uint8_t c = char_at(i + 2);
+        const uint8_t d = char_at(i + 3);
+        seen |= a | b | c | d;
+        DecodeGroup(a, b, c, d, group_bytes.data());
+        const int keep = bytes < 3 ? bytes : 3;
+        for (int j = 0; j < keep; ++j)
+        {
+            *out++ = group_bytes[j];
+        }
+    }
+    return seen;
+}
+
+} // namespace
+
+// ===  FUNCTION  ======================================================================
+//         Name:  UUDecode
+//  Description:  decode into a vector sized up front from the encoded length.
+//                the full line decoder is picked once, the first time we're called.
+// =====================================================================================
+std::vector<char> UUDecode(std::string_view content)
+{
+    static const FullLineFunction decode_full_line = ChooseFullLineDecoder();
+
+    // find the 'begin' line. it must start a line.
+
+    size_t begin_loc{0};
+    while (!content.substr(begin_loc).starts_with("begin "))
+    {
+        begin_loc = content.find('\n', begin_loc);
+        if (begin_loc == std::string_view::npos)
+        {
+            throw ExtractorException("UUDecode: can't find 'begin' line.");
+        }
+        ++begin_loc;
+    }
+    auto next_line = content.find('\n', begin_loc);
+    content.remove_prefix(next_line == std::string_view::npos ? content.size() : next_line + 1);
+
+    // 60 characters make 45 bytes. short lines can decode to more than this so
+    // we still check for room each line but it should never need to grow.
+
+    std::vector<char> result(content.size() / 4 * 3 + k_max_line_bytes);
+    size_t decoded{0};
+    int line_number{1};
+
+    while (!content.empty())
+    {
+        ++line_number;
+        auto line_end = content.find('\n');
+        auto line = content.substr(0, line_end);
+        content.remove_prefix(line_end == std::string_view::npos ? content.size() : line_end + 1);
+
+        if (line.ends_with('\r'))
+        {
+            line.remove_suffix(1);
+        }
+
+        // an empty line counts as a blank one which is the zero length line.
+
+        if (line.empty() || line == "end")
+        {
+            break;
+        }
+        const uint8_t length = DecodeChar(line[0]);
+        if (length == 0)
+        {
+            break;
+        }
+        if (length & k_bad_char)
+        {
+            throw ExtractorException(catenate("UUDecode: bad length character on line: ", line_number));
+        }
+
+        if (decoded + k_max_line_bytes > result.size())
+        {
+            result.resize(result.size() * 2);
+        }
+
+        const uint8_t seen = length == k_full_line_bytes && line.size() >= k_full_line_chars
+                                 ? decode_full_line(line.data() + 1, result.data() + decoded)
+                                 : DecodeLine(line.substr(1), length, result.data() + decoded);
+        if (seen & k_bad_char)
+        {
+            throw ExtractorException(catenate("UUDecode: bad character on line: ", line_number));
+        }
+        decoded += length;
+    }
+    result.resize(decoded);
+    return result;
+} /* -----  end of function UUDecode  ----- */
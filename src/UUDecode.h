@@ -0,0 +1,47 @@
+// =====================================================================================
+//
+//       Filename:  UUDecode.h
+//
+//    Description:  decode the uuencoded spreadsheets embedded in EDGAR filings
+//                  without running the uudecode program.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 03:12:40 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef UUDECODE_H_
+#define UUDECODE_H_
+
+#include <string_view>
+#include <vector>
+
+// content is everything from the 'begin' line on. anything before 'begin' is skipped
+// just like uudecode does. decoding stops at the zero length line ahead of 'end'.
+// short lines (trailing blanks trimmed somewhere along the way) are treated as if
+// they were padded with blanks.
+// throws ExtractorException if there is no 'begin' line or a line has bad characters.
+
+std::vector<char> UUDecode(std::string_view content);
+
+#endif /* UUDECODE_H_ */
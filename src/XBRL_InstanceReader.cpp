@@ -0,0 +1,881 @@
+// =====================================================================================
+//
+//       Filename:  XBRL_InstanceReader.cpp
+//
+//    Description:  Extract filing data, GAAP facts and contexts from an XBRL
+//                  instance document in 1 streaming pass.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 04:05:31 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "XBRL_InstanceReader.h"
+
+#include <expat.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "Extractor_Utils.h"
+#include "Extractor_XBRL_FileFilter.h"
+
+namespace
+{
+
+constexpr std::string_view k_us_gaap_ns{"us-gaap:"};
+const std::string k_us_gaap_pfx{"us-gaap_"};
+
+// expat copies what we give it into its own buffer so feed it a piece at a time.
+
+constexpr std::size_t k_parse_chunk{64 * 1024};
+
+bool IsXMLSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// the DOM is parsed with parse_wnorm_attribute: leading and trailing whitespace
+// dropped and runs of whitespace replaced by 1 space.
+
+std::string NormalizeAttribute(std::string_view value)
+{
+    std::string result;
+    bool in_space{false};
+    for (char c : value)
+    {
+        if (IsXMLSpace(c))
+        {
+            in_space = !result.empty();
+            continue;
+        }
+        if (in_space)
+        {
+            result += ' ';
+            in_space = false;
+        }
+        result += c;
+    }
+    return result;
+}
+
+std::string GetAttribute(const XML_Char **attributes, std::string_view name)
+{
+    for (; *attributes != nullptr; attributes += 2)
+    {
+        if (name == attributes[0])
+        {
+            return NormalizeAttribute(attributes[1]);
+        }
+    }
+    return {};
+}
+
+// pugixml takes any document which isn't UTF-16 or declared as Latin-1 to be UTF-8
+// and passes its bytes through without checking them. expat insists on a valid
+// document in an encoding it knows. so we tell expat those documents are Latin-1,
+// which takes any byte, and turn what it gives us back into the original bytes.
+// Latin-1 only makes 2 byte UTF-8 sequences and those start with 0xC2 or 0xC3.
+
+void AppendLatin1Bytes(std::string &result, std::string_view utf8)
+{
+    for (std::size_t i = 0; i < utf8.size(); ++i)
+    {
+        const auto c = static_cast<unsigned char>(utf8[i]);
+        if ((c == 0xC2 || c == 0xC3) && i + 1 < utf8.size())
+        {
+            result += static_cast<char>(((c & 0x03) << 6) | (static_cast<unsigned char>(utf8[++i]) & 0x3F));
+            continue;
+        }
+        result += utf8[i];
+    }
+}
+
+// an attribute value comes to us whole, with its references already decoded, so
+// we can't tell which bytes came from the document. when keeping the original
+// bytes we go back to the start tag and decode the value the way the DOM does:
+// document bytes as they are, references as UTF-8, whitespace normalized.
+// expat has already checked the tag is well formed.
+
+void AppendUTF8(std::string &result, unsigned int code_point)
+{
+    if (code_point < 0x80)
+    {
+        result += static_cast<char>(code_point);
+    }
+    else if (code_point < 0x800)
+    {
+        result += static_cast<char>(0xC0 | (code_point >> 6));
+        result += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000)
+    {
+        result += static_cast<char>(0xE0 | (code_point >> 12));
+        result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        result += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else
+    {
+        result += static_cast<char>(0xF0 | (code_point >> 18));
+        result += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        result += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+// value starts just past a '&'. returns how much of it the reference used.
+
+std::size_t AppendReference(std::string &result, std::string_view value)
+{
+    const auto end = value.find(';');
+    if (end == std::string_view::npos)
+    {
+        result += '&';
+        return 0;
+    }
+    const auto reference = value.substr(0, end);
+    if (reference.starts_with('#'))
+    {
+        const bool is_hex = reference.starts_with("#x");
+        unsigned int code_point{0};
+        for (char c : reference.substr(is_hex ? 2 : 1))
+        {
+            const auto lower = static_cast<char>(c | ' ');
+            code_point = code_point * (is_hex ? 16 : 10) +
+                         (lower >= 'a' && lower <= 'f' ? lower - 'a' + 10 : static_cast<unsigned int>(c - '0'));
+        }
+        AppendUTF8(result, code_point);
+        return end + 1;
+    }
+
+    static constexpr std::array<std::pair<std::string_view, char>, 5> k_predefined{
+        {{"amp", '&'}, {"lt", '<'}, {"gt", '>'}, {"quot", '"'}, {"apos", '\''}}};
+    auto found = std::ranges::find(k_predefined, reference, &std::pair<std::string_view, char>::first);
+    if (found == k_predefined.end())
+    {
+        // the DOM leaves anything else alone.
+
+        result += '&';
+        return 0;
+    }
+    result += found->second;
+    return end + 1;
+}
+
+std::string DecodeRawAttribute(std::string_view value)
+{
+    value.remove_prefix(std::min(value.find_first_not_of(" \t\r\n"), value.size()));
+
+    // only whitespace in the document is collapsed, not any a reference makes.
+
+    std::string result;
+    bool in_space{false};
+    for (std::size_t i = 0; i < value.size(); ++i)
+    {
+        const char c = value[i];
+        if (IsXMLSpace(c))
+        {
+            if (!in_space)
+            {
+                result += ' ';
+            }
+            in_space = true;
+            continue;
+        }
+        in_space = false;
+        if (c == '&')
+        {
+            i += AppendReference(result, value.substr(i + 1));
+            continue;
+        }
+        result += c;
+    }
+    while (!result.empty() && IsXMLSpace(result.back()))
+    {
+        result.pop_back();
+    }
+    return result;
+}
+
+// start_tag begins with the element's '<'.
+
+std::string GetRawAttribute(std::string_view start_tag, std::string_view name)
+{
+    auto is_name_end = [](char c) { return IsXMLSpace(c) || c == '=' || c == '>' || c == '/'; };
+    std::size_t pos{1};
+    while (pos < start_tag.size() && !is_name_end(start_tag[pos]))
+    {
+        ++pos;
+    }
+    while (pos < start_tag.size())
+    {
+        while (pos < start_tag.size() && IsXMLSpace(start_tag[pos]))
+        {
+            ++pos;
+        }
+        if (pos == start_tag.size() || start_tag[pos] == '>' || start_tag[pos] == '/')
+        {
+            break;
+        }
+        const auto name_start = pos;
+        while (pos < start_tag.size() && !is_name_end(start_tag[pos]))
+        {
+            ++pos;
+        }
+        const auto attribute_name = start_tag.substr(name_start, pos - name_start);
+
+        const auto quote = start_tag.find_first_of("\"'", pos);
+        if (quote == std::string_view::npos)
+        {
+            break;
+        }
+        const auto value_end = start_tag.find(start_tag[quote], quote + 1);
+        if (value_end == std::string_view::npos)
+        {
+            break;
+        }
+        if (attribute_name == name)
+        {
+            return DecodeRawAttribute(start_tag.substr(quote + 1, value_end - quote - 1));
+        }
+        pos = value_end + 1;
+    }
+    return {};
+}
+
+// the same test pugixml uses to decide whether a document without a BOM is Latin-1.
+
+bool IsDeclaredLatin1(std::string_view document)
+{
+    if (!document.starts_with("<?xm"))
+    {
+        return false;
+    }
+    auto declaration = document.substr(0, document.find("?>"));
+    auto encoding = declaration.find("encoding");
+    if (encoding == std::string_view::npos)
+    {
+        return false;
+    }
+    auto value = declaration.substr(encoding + 8);
+    value.remove_prefix(std::min(value.find_first_not_of(" \t\r\n"), value.size()));
+    if (!value.starts_with('='))
+    {
+        return false;
+    }
+    value.remove_prefix(1);
+    value.remove_prefix(std::min(value.find_first_not_of(" \t\r\n"), value.size()));
+    if (value.empty() || (value.front() != '"' && value.front() != '\''))
+    {
+        return false;
+    }
+    const char quote = value.front();
+    value.remove_prefix(1);
+    value = value.substr(0, value.find(quote));
+
+    auto lower = [](char c) { return static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c); };
+    std::string name;
+    std::ranges::transform(value, std::back_inserter(name), lower);
+    return name == "iso-8859-1" || name == "latin1";
+}
+
+// =====================================================================================
+//        Class:  InstanceReader
+//  Description:  expat callbacks and the little bit of state they need.
+//
+//                the DOM version reads node.child_value(): the first text node
+//                directly inside an element. pugixml drops whitespace only text but
+//                keeps CDATA no matter what and a child element, comment or
+//                processing instruction ends a text node. we follow the same rules
+//                for the few elements whose text we keep.
+// =====================================================================================
+
+class InstanceReader
+{
+public:
+    enum class Capture
+    {
+        e_None,
+        e_GAAP,
+        e_TradingSymbol,
+        e_SharesOutstanding,
+        e_PeriodEndDate,
+        e_Instant,
+        e_StartDate,
+        e_EndDate
+    };
+
+    // if the root element uses a namespace prefix, contexts should too but
+    // some files only use 'xbrli:' on their contexts.
+
+    struct ContextNames
+    {
+        std::string context_;
+        std::string period_;
+        std::string instant_;
+        std::string start_;
+        std::string end_;
+        EM::ContextPeriod contexts_;
+        bool found_ = false;
+    };
+
+    // parser and document are only needed when keeping the original bytes.
+
+    InstanceReader(XML_Parser parser, std::string_view document, bool keep_bytes)
+        : parser_{parser}, document_{document}, keep_bytes_{keep_bytes}
+    {
+    }
+
+    void StartElement(std::string_view name, const XML_Char **attributes);
+    void EndElement();
+    void CharacterData(std::string_view text);
+    void EndTextRun(bool is_cdata);
+    void StartCdata();
+    void EndCdata();
+
+    XBRL_InstanceData Finish();
+
+private:
+    void SetContextNames(std::string_view root_name);
+    void StartCapture(Capture capture);
+    void EndCapture();
+    std::string Attribute(const XML_Char **attributes, std::string_view name) const;
+
+    XML_Parser parser_;
+    std::string_view document_;
+    bool keep_bytes_;
+    bool in_cdata_ = false;
+
+    XBRL_InstanceData data_;
+
+    std::string trading_symbol_;
+    std::string shares_outstanding_;
+    std::string period_end_date_;
+    bool found_trading_symbol_ = false;
+    bool found_shares_outstanding_ = false;
+    bool found_period_end_date_ = false;
+
+    std::array<ContextNames, 2> context_names_;
+    std::size_t context_name_count_ = 1;
+
+    // the context we're in, if any, and what we've found in it.
+
+    ContextNames *context_ = nullptr;
+    std::string context_ID_;
+    std::string instant_;
+    std::string start_date_;
+    std::string end_date_;
+    bool found_period_ = false;
+    bool in_period_ = false;
+    bool found_instant_ = false;
+    bool found_start_ = false;
+    bool found_end_ = false;
+
+    // the GAAP fact we're in. value comes from the captured text.
+
+    EM::GAAP_Data fact_;
+
+    int depth_ = 0;
+    Capture capture_ = Capture::e_None;
+    int capture_depth_ = 0;
+    std::string text_;
+    bool text_done_ = false;
+
+}; // -----  end of class InstanceReader  -----
+
+void InstanceReader::SetContextNames(std::string_view root_name)
+{
+    std::string namespace_prefix;
+    if (auto pos = root_name.find(':'); pos != std::string_view::npos)
+    {
+        namespace_prefix = root_name.substr(0, pos + 1);
+    }
+
+    auto set_names = [](ContextNames &names, const std::string &prefix) {
+        names.context_ = prefix + "context";
+        names.period_ = prefix + "period";
+        names.instant_ = prefix + "instant";
+        names.start_ = prefix + "startDate";
+        names.end_ = prefix + "endDate";
+    };
+    set_names(context_names_[0], namespace_prefix);
+    if (namespace_prefix != "xbrli:")
+    {
+        set_names(context_names_[1], "xbrli:");
+        context_name_count_ = 2;
+    }
+} // -----  end of method InstanceReader::SetContextNames  -----
+
+std::string InstanceReader::Attribute(const XML_Char **attributes, std::string_view name) const
+{
+    if (keep_bytes_)
+    {
+        return GetRawAttribute(document_.substr(XML_GetCurrentByteIndex(parser_)), name);
+    }
+    return GetAttribute(attributes, name);
+} // -----  end of method InstanceReader::Attribute  -----
+
+void InstanceReader::StartCapture(Capture capture)
+{
+    capture_ = capture;
+    capture_depth_ = depth_;
+    text_.clear();
+    text_done_ = false;
+} // -----  end of method InstanceReader::StartCapture  -----
+
+void InstanceReader::StartElement(std::string_view name, const XML_Char **attributes)
+{
+    // a child element ends the text node of its parent.
+
+    EndTextRun(false);
+    ++depth_;
+
+    if (depth_ == 1)
+    {
+        SetContextNames(name);
+        return;
+    }
+
+    if (depth_ == 2)
+    {
+        if (name.starts_with(k_us_gaap_ns))
+        {
+            // facts without units (text blocks, mostly) are never kept so
+            // we don't need to collect their text.
+
+            fact_.units = Attribute(attributes, "unitRef");
+            if (!fact_.units.empty())
+            {
+                fact_.label = k_us_gaap_pfx;
+                if (keep_bytes_)
+                {
+                    AppendLatin1Bytes(fact_.label, name.substr(k_us_gaap_ns.size()));
+                }
+                else
+                {
+                    fact_.label += name.substr(k_us_gaap_ns.size());
+                }
+                fact_.context_ID = Attribute(attributes, "contextRef");
+                fact_.decimals = Attribute(attributes, "decimals");
+                StartCapture(Capture::e_GAAP);
+            }
+            return;
+        }
+        if (name == "dei:TradingSymbol" && !found_trading_symbol_)
+        {
+            found_trading_symbol_ = true;
+            StartCapture(Capture::e_TradingSymbol);
+            return;
+        }
+        if (name == "dei:EntityCommonStockSharesOutstanding" && !found_shares_outstanding_)
+        {
+            found_shares_outstanding_ = true;
+            StartCapture(Capture::e_SharesOutstanding);
+            return;
+        }
+        if (name == "dei:DocumentPeriodEndDate" && !found_period_end_date_)
+        {
+            found_period_end_date_ = true;
+            StartCapture(Capture::e_PeriodEndDate);
+            return;
+        }
+        for (std::size_t i = 0; i < context_name_count_; ++i)
+        {
+            if (name == context_names_[i].context_)
+            {
+                context_ = &context_names_[i];
+                context_->found_ = true;
+                context_ID_ = Attribute(attributes, "id");
+                instant_.clear();
+                start_date_.clear();
+                end_date_.clear();
+                found_period_ = false;
+                found_instant_ = false;
+                found_start_ = false;
+                found_end_ = false;
+                return;
+            }
+        }
+        return;
+    }
+
+    // only the first period of a context and the first of each date in it count.
+
+    if (context_ == nullptr)
+    {
+        return;
+    }
+    if (depth_ == 3 && name == context_->period_ && !found_period_)
+    {
+        found_period_ = true;
+        in_period_ = true;
+        return;
+    }
+    if (depth_ == 4 && in_period_)
+    {
+        if (name == context_->instant_ && !found_instant_)
+        {
+            found_instant_ = true;
+            StartCapture(Capture::e_Instant);
+        }
+        else if (name == context_->start_ && !found_start_)
+        {
+            found_start_ = true;
+            StartCapture(Capture::e_StartDate);
+        }
+        else if (name == context_->end_ && !found_end_)
+        {
+            found_end_ = true;
+            StartCapture(Capture::e_EndDate);
+        }
+    }
+} // -----  end of method InstanceReader::StartElement  -----
+
+void InstanceReader::EndElement()
+{
+    if (capture_ != Capture::e_None && depth_ == capture_depth_)
+    {
+        EndTextRun(false);
+        EndCapture();
+    }
+
+    if (context_ != nullptr)
+    {
+        if (depth_ == 3)
+        {
+            in_period_ = false;
+        }
+        else if (depth_ == 2)
+        {
+            EM::Extractor_TimePeriod period = found_instant_ ? EM::Extractor_TimePeriod{instant_, instant_}
+                                                             : EM::Extractor_TimePeriod{start_date_, end_date_};
+            if (auto [it, success] = context_->contexts_.try_emplace(context_ID_, std::move(period)); !success)
+            {
+                spdlog::debug(catenate("Can't insert value for label: ", context_ID_).c_str());
+            }
+            context_ = nullptr;
+        }
+    }
+    --depth_;
+} // -----  end of method InstanceReader::EndElement  -----
+
+void InstanceReader::CharacterData(std::string_view text)
+{
+    if (capture_ == Capture::e_None || depth_ != capture_depth_ || text_done_)
+    {
+        return;
+    }
+
+    // expat reports each character or entity reference on its own. those are
+    // already UTF-8 for pugixml too. everything else came from the document.
+
+    if (keep_bytes_ && (in_cdata_ || document_[XML_GetCurrentByteIndex(parser_)] != '&'))
+    {
+        AppendLatin1Bytes(text_, text);
+        return;
+    }
+    text_.append(text);
+} // -----  end of method InstanceReader::CharacterData  -----
+
+void InstanceReader::StartCdata()
+{
+    EndTextRun(false);
+    in_cdata_ = true;
+} // -----  end of method InstanceReader::StartCdata  -----
+
+void InstanceReader::EndCdata()
+{
+    in_cdata_ = false;
+    EndTextRun(true);
+} // -----  end of method InstanceReader::EndCdata  -----
+
+void InstanceReader::EndTextRun(bool is_cdata)
+{
+    if (capture_ == Capture::e_None || depth_ != capture_depth_ || text_done_)
+    {
+        return;
+    }
+    if (is_cdata || !std::ranges::all_of(text_, IsXMLSpace))
+    {
+        text_done_ = true;
+    }
+    else
+    {
+        text_.clear();
+    }
+} // -----  end of method InstanceReader::EndTextRun  -----
+
+void InstanceReader::EndCapture()
+{
+    switch (capture_)
+    {
+    case Capture::e_GAAP:
+        // need to filter out table type content.
+
+        if (!text_.empty() && text_.find("<table") == std::string::npos && text_.find("<div") == std::string::npos &&
+            text_.find("<p ") == std::string::npos)
+        {
+            fact_.value = std::move(text_);
+            data_.gaap_data_.push_back(std::move(fact_));
+        }
+        fact_ = {};
+        break;
+    case Capture::e_TradingSymbol:
+        trading_symbol_ = std::move(text_);
+        break;
+    case Capture::e_SharesOutstanding:
+        shares_outstanding_ = std::move(text_);
+        break;
+    case Capture::e_PeriodEndDate:
+        period_end_date_ = std::move(text_);
+        break;
+    case Capture::e_Instant:
+        instant_ = std::move(text_);
+        break;
+    case Capture::e_StartDate:
+        start_date_ = std::move(text_);
+        break;
+    case Capture::e_EndDate:
+        end_date_ = std::move(text_);
+        break;
+    case Capture::e_None:
+        break;
+    }
+    capture_ = Capture::e_None;
+    capture_depth_ = 0;
+    text_.clear();
+} // -----  end of method InstanceReader::EndCapture  -----
+
+XBRL_InstanceData InstanceReader::Finish()
+{
+    auto context_ID = ConvertPeriodEndDateToContextName(period_end_date_);
+    data_.filing_data_ = EM::FilingData{std::move(trading_symbol_), std::move(period_end_date_), std::move(context_ID),
+                                        shares_outstanding_.empty() ? "-1" : std::move(shares_outstanding_)};
+
+    auto found = std::ranges::find_if(context_names_.begin(), context_names_.begin() + context_name_count_,
+                                      [](const auto &names) { return names.found_; });
+    if (found == context_names_.begin() + context_name_count_)
+    {
+        throw XBRLException("Can't find 'context' section in file.");
+    }
+    data_.context_data_ = std::move(found->contexts_);
+
+    return std::move(data_);
+} // -----  end of method InstanceReader::Finish  -----
+
+// expat wants plain functions.
+
+void OnStartElement(void *user_data, const XML_Char *name, const XML_Char **attributes)
+{
+    static_cast<InstanceReader *>(user_data)->StartElement(name, attributes);
+}
+
+void OnEndElement(void *user_data, const XML_Char * /* name */)
+{
+    static_cast<InstanceReader *>(user_data)->EndElement();
+}
+
+void OnCharacterData(void *user_data, const XML_Char *text, int len)
+{
+    static_cast<InstanceReader *>(user_data)->CharacterData({text, static_cast<std::size_t>(len)});
+}
+
+void OnComment(void *user_data, const XML_Char * /* comment */)
+{
+    static_cast<InstanceReader *>(user_data)->EndTextRun(false);
+}
+
+void OnProcessingInstruction(void *user_data, const XML_Char * /* target */, const XML_Char * /* data */)
+{
+    static_cast<InstanceReader *>(user_data)->EndTextRun(false);
+}
+
+void OnStartCdata(void *user_data)
+{
+    static_cast<InstanceReader *>(user_data)->StartCdata();
+}
+
+void OnEndCdata(void *user_data)
+{
+    static_cast<InstanceReader *>(user_data)->EndCdata();
+}
+
+} // namespace
+
+// ===  FUNCTION  ======================================================================
+//         Name:  ExtractInstanceData
+//  Description:  1 pass over the instance document collecting all we need from it.
+// =====================================================================================
+XBRL_InstanceData ExtractInstanceData(EM::XBRLContent instance_document)
+{
+    EM::sv document{instance_document.get()};
+
+    // work out the encoding the way pugixml does. expat can find UTF-16 on its own.
+    // anything else it has to be told or it goes by the XML declaration and turns
+    // down encodings it doesn't know, like windows-1252.
+
+    const char *encoding{"ISO-8859-1"};
+    bool keep_bytes{true};
+    if (document.starts_with("\xFE\xFF") || document.starts_with("\xFF\xFE") ||
+        document.starts_with(EM::sv{"\0<\0?", 4}) || document.starts_with(EM::sv{"<\0?\0", 4}))
+    {
+        encoding = nullptr;
+        keep_bytes = false;
+    }
+    else if (document.starts_with("\xEF\xBB\xBF"))
+    {
+        document.remove_prefix(3);
+    }
+    else if (IsDeclaredLatin1(document))
+    {
+        keep_bytes = false;
+    }
+
+    // pugixml skips whitespace ahead of the XML declaration. expat won't.
+
+    if (encoding != nullptr)
+    {
+        if (auto start = document.find_first_not_of(" \t\r\n"); start != EM::sv::npos)
+        {
+            document.remove_prefix(start);
+        }
+    }
+
+    auto parser_closer = [](XML_Parser parser) { XML_ParserFree(parser); };
+    std::unique_ptr<std::remove_pointer_t<XML_Parser>, std::function<void(XML_Parser)>> parser{
+        XML_ParserCreate(encoding), parser_closer};
+    if (!parser)
+    {
+        throw XBRLException("Can't create XML parser.");
+    }
+
+    InstanceReader reader{parser.get(), document, keep_bytes};
+
+    XML_SetUserData(parser.get(), &reader);
+    XML_SetElementHandler(parser.get(), OnStartElement, OnEndElement);
+    XML_SetCharacterDataHandler(parser.get(), OnCharacterData);
+    XML_SetCommentHandler(parser.get(), OnComment);
+    XML_SetProcessingInstructionHandler(parser.get(), OnProcessingInstruction);
+    XML_SetCdataSectionHandler(parser.get(), OnStartCdata, OnEndCdata);
+
+    bool is_final{false};
+    while (!is_final)
+    {
+        auto chunk = document.substr(0, k_parse_chunk);
+        document.remove_prefix(chunk.size());
+        is_final = document.empty();
+
+        if (XML_Parse(parser.get(), chunk.data(), static_cast<int>(chunk.size()), is_final) == XML_STATUS_ERROR)
+        {
+            throw XBRLException{catenate("Error description: ", XML_ErrorString(XML_GetErrorCode(parser.get())),
+                                         "\nError offset: ", XML_GetCurrentByteIndex(parser.get()), '\n')};
+        }
+    }
+
+    return reader.Finish();
+} /* -----  end of function ExtractInstanceData  ----- */
+
+// ===  FUNCTION  ======================================================================
+//         Name:  CompareWithDOM
+//  Description:  run the pugixml versions over the same document and note where
+//                they disagree with what ExtractInstanceData found.
+// =====================================================================================
+std::vector<std::string> CompareWithDOM(EM::XBRLContent instance_document, const XBRL_InstanceData &instance_data)
+{
+    std::vector<std::string> differences;
+
+    XBRL_InstanceData DOM_data;
+    try
+    {
+        auto instance_xml = ParseXMLContent(instance_document);
+        DOM_data.filing_data_ = ExtractFilingData(instance_xml);
+        DOM_data.gaap_data_ = ExtractGAAPFields(instance_xml);
+        DOM_data.context_data_ = ExtractContextDefinitions(instance_xml);
+    }
+    catch (const std::exception &e)
+    {
+        differences.push_back(catenate("DOM version failed: ", e.what()));
+        return differences;
+    }
+
+    auto compare = [&differences](std::string_view what, const std::string &ours, const std::string &DOMs) {
+        if (ours != DOMs)
+        {
+            differences.push_back(catenate(what, ": '", ours, "' DOM: '", DOMs, "'"));
+        }
+    };
+
+    compare("trading symbol", instance_data.filing_data_.trading_symbol, DOM_data.filing_data_.trading_symbol);
+    compare("period end date", instance_data.filing_data_.period_end_date, DOM_data.filing_data_.period_end_date);
+    compare("period context ID", instance_data.filing_data_.period_context_ID,
+            DOM_data.filing_data_.period_context_ID);
+    compare("shares outstanding", instance_data.filing_data_.shares_outstanding,
+            DOM_data.filing_data_.shares_outstanding);
+
+    if (instance_data.gaap_data_.size() != DOM_data.gaap_data_.size())
+    {
+        differences.push_back(catenate("GAAP facts: ", instance_data.gaap_data_.size(),
+                                       " DOM: ", DOM_data.gaap_data_.size()));
+    }
+    const auto facts = std::min(instance_data.gaap_data_.size(), DOM_data.gaap_data_.size());
+    for (std::size_t i = 0; i < facts; ++i)
+    {
+        const auto &ours = instance_data.gaap_data_[i];
+        const auto &DOMs = DOM_data.gaap_data_[i];
+        auto fact = catenate("GAAP fact ", i, ' ');
+        compare(fact + "label", ours.label, DOMs.label);
+        compare(fact + "context ID", ours.context_ID, DOMs.context_ID);
+        compare(fact + "units", ours.units, DOMs.units);
+        compare(fact + "decimals", ours.decimals, DOMs.decimals);
+        compare(fact + "value", ours.value, DOMs.value);
+    }
+
+    for (const auto &[context_ID, period] : instance_data.context_data_)
+    {
+        auto DOM_period = DOM_data.context_data_.find(context_ID);
+        if (DOM_period == DOM_data.context_data_.end())
+        {
+            differences.push_back(catenate("context: ", context_ID, " not found by DOM"));
+            continue;
+        }
+        compare(catenate("context ", context_ID, " begin"), period.begin, DOM_period->second.begin);
+        compare(catenate("context ", context_ID, " end"), period.end, DOM_period->second.end);
+    }
+    for (const auto &[context_ID, period] : DOM_data.context_data_)
+    {
+        if (!instance_data.context_data_.contains(context_ID))
+        {
+            differences.push_back(catenate("context: ", context_ID, " only found by DOM"));
+        }
+    }
+
+    return differences;
+} /* -----  end of function CompareWithDOM  ----- */
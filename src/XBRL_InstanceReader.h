@@ -0,0 +1,64 @@
+// =====================================================================================
+//
+//       Filename:  XBRL_InstanceReader.h
+//
+//    Description:  Extract filing data, GAAP facts and contexts from an XBRL
+//                  instance document in 1 streaming pass.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 04:05:31 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef XBRL_INSTANCEREADER_H_
+#define XBRL_INSTANCEREADER_H_
+
+#include <string>
+#include <vector>
+
+#include "Extractor.h"
+
+// everything we take from an instance document.
+
+struct XBRL_InstanceData
+{
+    EM::FilingData filing_data_;
+    std::vector<EM::GAAP_Data> gaap_data_;
+    EM::ContextPeriod context_data_;
+};
+
+// reads the document once with expat instead of building a pugixml DOM and walking
+// it 3 times. only the text we keep is ever copied so memory use doesn't grow with
+// the size of the document.
+// results are the same as ExtractFilingData, ExtractGAAPFields and
+// ExtractContextDefinitions applied to ParseXMLContent of the same document.
+// throws XBRLException for bad XML or when there are no contexts.
+
+XBRL_InstanceData ExtractInstanceData(EM::XBRLContent instance_document);
+
+// for checking the above: parses the document with pugixml, runs the DOM versions
+// and describes each place they differ from instance_data. empty when they agree.
+
+std::vector<std::string> CompareWithDOM(EM::XBRLContent instance_document, const XBRL_InstanceData &instance_data);
+
+#endif /* XBRL_INSTANCEREADER_H_ */
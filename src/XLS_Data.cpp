@@ -16,56 +16,243 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <limits>
 #include <range/v3/action/transform.hpp>
 #include <range/v3/algorithm/find_if.hpp>
 #include <range/v3/algorithm/transform.hpp>
 #include <range/v3/iterator.hpp>
+#include <utility>
 
 namespace rng = ranges;
 
 #include "Extractor_Utils.h"
 #include "XLS_Data.h"
 
+//--------------------------------------------------------------------------------------
+//       Class:  XLS_Workbook
+//      Method:  XLS_Workbook
+// Description:  constructor
+//--------------------------------------------------------------------------------------
+
+XLS_Workbook::XLS_Workbook(std::vector<char> &&content) : content_{std::move(content)}
+{
+    if (content_.empty())
+    {
+        return;
+    }
+
+    // it's possible we won't be able to read the data in which case
+    // we have no sheets.  All downstream classes should be prepared for this.
+
+    xlsxioread_ = xlsxioread_open_memory(content_.data(), content_.size(), 0);
+    if (xlsxioread_ == nullptr)
+    {
+        return;
+    }
+
+    auto list_closer = [](xlsxioreadersheetlist sheet_list) { xlsxioread_sheetlist_close(sheet_list); };
+
+    std::unique_ptr<xlsxio_read_sheetlist_struct, std::function<void(xlsxioreadersheetlist)>> sheet_list = {
+        xlsxioread_sheetlist_open(xlsxioread_), list_closer};
+    if (!sheet_list)
+    {
+        return;
+    }
+
+    const XLSXIOCHAR *sheet_name = nullptr;
+    while ((sheet_name = xlsxioread_sheetlist_next(sheet_list.get())) != nullptr)
+    {
+        auto &sheet = sheets_.emplace_back();
+        sheet.name_mc_ = sheet_name;
+        rng::transform(sheet.name_mc_, rng::back_inserter(sheet.name_lc_),
+                       [](unsigned char c) { return std::tolower(c); });
+    }
+} // -----  end of method XLS_Workbook::XLS_Workbook  (constructor)  -----
+
+XLS_Workbook::~XLS_Workbook()
+{
+    if (xlsxioread_ != nullptr)
+    {
+        xlsxioread_close(xlsxioread_);
+    }
+} // -----  end of method XLS_Workbook::~XLS_Workbook  (destructor)  -----
+
+const std::string &XLS_Workbook::GetSheetName(std::size_t sheet) const
+{
+    return sheets_.at(sheet).name_lc_;
+} // -----  end of method XLS_Workbook::GetSheetName  -----
+
+const std::string &XLS_Workbook::GetSheetTitle(std::size_t sheet) const
+{
+    // the title is the content of the first cell. we only need to read
+    // the whole sheet if we haven't already.
+
+    const auto &info = sheets_.at(sheet);
+    if (!info.title_)
+    {
+        std::string title;
+        auto first_cell = [&title](const XLS_SheetCells &sheet_cells) {
+            if (sheet_cells.RowCount() > 0 && !sheet_cells.Row(0).empty())
+            {
+                auto cell = sheet_cells.Row(0).front();
+                title = cell.substr(0, cell.find('\t'));
+            }
+        };
+        if (info.cells_)
+        {
+            first_cell(*info.cells_);
+        }
+        else
+        {
+            first_cell(ReadCells(sheet, 1));
+        }
+        title |= rng::actions::transform([](unsigned char c) { return std::tolower(c); });
+        info.title_ = std::move(title);
+    }
+    return *info.title_;
+} // -----  end of method XLS_Workbook::GetSheetTitle  -----
+
+const XLS_SheetCells &XLS_Workbook::GetSheetCells(std::size_t sheet) const
+{
+    const auto &info = sheets_.at(sheet);
+    if (!info.cells_)
+    {
+        info.cells_ = ReadCells(sheet, std::numeric_limits<std::size_t>::max());
+    }
+    return *info.cells_;
+} // -----  end of method XLS_Workbook::GetSheetCells  -----
+
+namespace
+{
+
+// xlsxio hands the callbacks each cell's value in its own buffer so there
+// is nothing for us to free. we collect end offsets while the text buffer
+// is still growing and make the views once it's done.
+
+struct CellCollector
+{
+    XLS_SheetCells sheet_cells_;
+    std::vector<std::size_t> cell_ends_;
+    std::size_t row_cells_ = 0;
+    std::size_t max_rows_ = 0;
+};
+
+int CollectCell(size_t /* row */, size_t col, const XLSXIOCHAR *value, void *callback_data)
+{
+    auto *collector = static_cast<CellCollector *>(callback_data);
+
+    // columns are 1 based. fill in any cells xlsxio skipped over.
+
+    for (; collector->row_cells_ + 1 < col; ++collector->row_cells_)
+    {
+        collector->cell_ends_.push_back(collector->sheet_cells_.text_.size());
+    }
+    if (value != nullptr)
+    {
+        auto &text = collector->sheet_cells_.text_;
+        text.insert(text.end(), value, value + std::strlen(value));
+    }
+    collector->cell_ends_.push_back(collector->sheet_cells_.text_.size());
+    ++collector->row_cells_;
+    return 0;
+}
+
+int CollectRow(size_t /* row */, size_t /* max_col */, void *callback_data)
+{
+    auto *collector = static_cast<CellCollector *>(callback_data);
+
+    collector->sheet_cells_.row_starts_.push_back(collector->cell_ends_.size());
+    collector->row_cells_ = 0;
+
+    // a non-zero return tells xlsxio to stop reading.
+
+    return collector->sheet_cells_.RowCount() < collector->max_rows_ ? 0 : 1;
+}
+
+} // namespace
+
+XLS_SheetCells XLS_Workbook::ReadCells(std::size_t sheet, std::size_t max_rows) const
+{
+    CellCollector collector;
+    collector.max_rows_ = max_rows;
+    collector.sheet_cells_.row_starts_.push_back(0);
+
+    xlsxioread_process(xlsxioread_, sheets_[sheet].name_mc_.c_str(), 0, CollectCell, CollectRow, &collector);
+
+    // a partial row means we stopped early. drop it.
+
+    auto &sheet_cells = collector.sheet_cells_;
+    collector.cell_ends_.resize(sheet_cells.row_starts_.back());
+
+    sheet_cells.cells_.reserve(collector.cell_ends_.size());
+    std::size_t cell_begin = 0;
+    for (auto cell_end : collector.cell_ends_)
+    {
+        sheet_cells.cells_.emplace_back(sheet_cells.text_.data() + cell_begin, cell_end - cell_begin);
+        cell_begin = cell_end;
+    }
+    return std::move(sheet_cells);
+} // -----  end of method XLS_Workbook::ReadCells  -----
+
+//--------------------------------------------------------------------------------------
+//       Class:  XLS_Row
+//      Method:  Text
+// Description:  the row laid out the way we used to read it.
+//--------------------------------------------------------------------------------------
+std::string XLS_Row::Text() const
+{
+    std::string text;
+    for (auto cell : cells_)
+    {
+        text += cell;
+        text += '\t';
+    }
+    text += '\n';
+    return text;
+} // -----  end of method XLS_Row::Text  -----
+
 //--------------------------------------------------------------------------------------
 //       Class:  XLS_File
 //      Method:  XLS_File
 // Description:  constructor
 //--------------------------------------------------------------------------------------
 
-XLS_File::XLS_File(const std::vector<char> &content) : content_{content}
+XLS_File::XLS_File(const std::vector<char> &content)
+    : workbook_{std::make_shared<XLS_Workbook>(std::vector<char>{content})}
 {
 } // -----  end of method XLS_File::XLS_File  (constructor)  -----
 
-XLS_File::XLS_File(std::vector<char> &&content) : content_{std::move(content)}
+XLS_File::XLS_File(std::vector<char> &&content) : workbook_{std::make_shared<XLS_Workbook>(std::move(content))}
 {
 } // -----  end of method XLS_File::XLS_File  (constructor)  -----
 
-XLS_File::XLS_File(const XLS_File &rhs) : content_{rhs.content_}
+XLS_File::XLS_File(const XLS_File &rhs) : workbook_{rhs.workbook_}
 {
 } // -----  end of method XLS_File::XLS_File  (constructor)  -----
 
-XLS_File::XLS_File(XLS_File &&rhs) noexcept : content_{std::move(rhs.content_)}
+XLS_File::XLS_File(XLS_File &&rhs) noexcept : workbook_{std::move(rhs.workbook_)}
 {
 } // -----  end of method XLS_File::XLS_File  (constructor)  -----
 
 XLS_File::iterator XLS_File::begin()
 {
-    if (content_.empty())
+    if (empty())
     {
         return {};
     }
 
-    return {&content_};
+    return sheet_itor{workbook_};
 } // -----  end of method XLS_File::begin  -----
 
 XLS_File::const_iterator XLS_File::begin() const
 {
-    if (content_.empty())
+    if (empty())
     {
         return {};
     }
 
-    return {&content_};
+    return sheet_itor{workbook_};
 } // -----  end of method XLS_File::begin  -----
 
 XLS_File::iterator XLS_File::end()
@@ -82,7 +269,7 @@ XLS_File &XLS_File::operator=(const XLS_File &rhs)
 {
     if (&rhs != this)
     {
-        content_ = rhs.content_;
+        workbook_ = rhs.workbook_;
     }
     return *this;
 } // -----  end of method XLS_File::operator=  -----
@@ -91,39 +278,24 @@ XLS_File &XLS_File::operator=(XLS_File &&rhs) noexcept
 {
     if (&rhs != this)
     {
-        content_ = std::move(rhs.content_);
+        workbook_ = std::move(rhs.workbook_);
     }
     return *this;
 } // -----  end of method XLS_File::operator=  -----
 
 std::vector<std::string> XLS_File::GetSheetNames() const
 {
-    if (content_.empty())
+    if (empty())
     {
         return {};
     }
 
-    auto file_closer = [](xlsxioreader file) { xlsxioread_close(file); };
-    std::unique_ptr<xlsxio_read_struct, std::function<void(xlsxioreader)>> xlsxioread{
-        xlsxioread_open_memory(const_cast<char *>(content_.data()), content_.size(), 0), file_closer};
-
     std::vector<std::string> results;
+    results.reserve(workbook_->SheetCount());
 
-    if (xlsxioread)
+    for (std::size_t sheet = 0; sheet < workbook_->SheetCount(); ++sheet)
     {
-        auto list_closer = [](xlsxioreadersheetlist sheet_list) { xlsxioread_sheetlist_close(sheet_list); };
-
-        std::unique_ptr<xlsxio_read_sheetlist_struct, std::function<void(xlsxioreadersheetlist)>> temp_list = {
-            xlsxioread_sheetlist_open(xlsxioread.get()), list_closer};
-        if (temp_list)
-        {
-            const XLSXIOCHAR *tempname = nullptr;
-            while ((tempname = xlsxioread_sheetlist_next(temp_list.get())) != nullptr)
-            {
-                results.emplace_back(std::string{tempname});
-                results.back() |= rng::actions::transform([](unsigned char c) { return std::tolower(c); });
-            }
-        }
+        results.push_back(workbook_->GetSheetName(sheet));
     }
     return results;
 } // -----  end of method XLS_File::GetSheetNames  -----
@@ -166,213 +338,30 @@ std::optional<XLS_Sheet> XLS_File::FindSheetByInternalName(EM::sv sheet_name) co
 // Description:  constructor
 //--------------------------------------------------------------------------------------
 
-XLS_File::sheet_itor::sheet_itor(const std::vector<char> *content) : content_{content}
+XLS_File::sheet_itor::sheet_itor(std::shared_ptr<XLS_Workbook> workbook)
 {
-    if (content_ == nullptr)
-    {
-        return;
-    }
-
-    // it's possible we won't be able to read the data in which case
-    // our handle will be null.  All downstream classes should be prepared for this.
-
-    xlsxioread_ = xlsxioread_open_memory(const_cast<char *>(content_->data()), content_->size(), 0);
-
-    if (xlsxioread_ == nullptr)
-    {
-        return;
-    }
-    sheet_list_ = xlsxioread_sheetlist_open(xlsxioread_);
-    if (sheet_list_ == nullptr)
-    {
-        xlsxioread_close(xlsxioread_);
-        xlsxioread_ = nullptr;
-        return;
-    }
-
-    sheet_name_ = xlsxioread_sheetlist_next(sheet_list_);
-    if (sheet_name_ == nullptr)
-    {
-        // end of sheets
-        xlsxioread_sheetlist_close(sheet_list_);
-        sheet_list_ = nullptr;
-        xlsxioread_close(xlsxioread_);
-        xlsxioread_ = nullptr;
-        return;
-    }
-
-    current_sheet_ = {content_, sheet_name_};
-
-} // -----  end of method XLS_File::sheet_itor::sheet_itor  (constructor)  -----
-
-XLS_File::sheet_itor::sheet_itor(const sheet_itor &rhs) : content_{rhs.content_}
-{
-    if (content_ == nullptr || rhs.sheet_name_ == nullptr)
-    {
-        return;
-    }
-
-    xlsxioread_ = xlsxioread_open_memory(const_cast<char *>(content_->data()), content_->size(), 0);
-
-    if (xlsxioread_ == nullptr)
-    {
-        return;
-    }
-
-    sheet_list_ = xlsxioread_sheetlist_open(xlsxioread_);
-    if (sheet_list_ == nullptr)
-    {
-        xlsxioread_close(xlsxioread_);
-        xlsxioread_ = nullptr;
-        return;
-    }
-
-    // need to match position of rhs.
-
-    while (current_sheet_ != rhs.current_sheet_)
-    {
-        this->operator++();
-    }
-
-} // -----  end of method XLS_File::sheet_itor::sheet_itor  (constructor)  -----
-
-XLS_File::sheet_itor::sheet_itor(sheet_itor &&rhs) noexcept
-
-{
-    content_ = rhs.content_;
-    sheet_name_ = rhs.sheet_name_;
-    xlsxioread_ = rhs.xlsxioread_;
-    sheet_list_ = rhs.sheet_list_;
-    current_sheet_ = std::move(rhs.current_sheet_);
-
-    rhs.content_ = nullptr;
-    rhs.sheet_name_ = nullptr;
-    rhs.xlsxioread_ = nullptr;
-    rhs.sheet_list_ = nullptr;
-
-} // -----  end of method XLS_File::sheet_itor::sheet_itor  (constructor)  -----
-
-XLS_File::sheet_itor::~sheet_itor()
-{
-    if (sheet_list_ != nullptr)
-    {
-        xlsxioread_sheetlist_close(sheet_list_);
-    }
-    if (xlsxioread_ != nullptr)
+    if (workbook && workbook->SheetCount() > 0)
     {
-        xlsxioread_close(xlsxioread_);
+        current_sheet_ = {std::move(workbook), 0};
     }
 } // -----  end of method XLS_File::sheet_itor::sheet_itor  (constructor)  -----
 
-XLS_File::sheet_itor &XLS_File::sheet_itor::operator=(const sheet_itor &rhs)
+XLS_File::sheet_itor &XLS_File::sheet_itor::operator++()
 {
-    if (&rhs != this)
+    if (current_sheet_.empty())
     {
-        if (sheet_list_ != nullptr)
-        {
-            xlsxioread_sheetlist_close(sheet_list_);
-            sheet_list_ = nullptr;
-        }
-        if (xlsxioread_ != nullptr)
-        {
-            xlsxioread_close(xlsxioread_);
-            xlsxioread_ = nullptr;
-        }
-        sheet_name_ = nullptr;
-        current_sheet_ = {};
-
-        content_ = rhs.content_;
-
-        xlsxioread_ = xlsxioread_open_memory(const_cast<char *>(content_->data()), content_->size(), 0);
-
-        if (xlsxioread_ == nullptr)
-        {
-            return *this;
-        }
-
-        sheet_list_ = xlsxioread_sheetlist_open(xlsxioread_);
-        if (sheet_list_ == nullptr)
-        {
-            xlsxioread_close(xlsxioread_);
-            xlsxioread_ = nullptr;
-            return *this;
-        }
-
-        // need to match position of rhs.
-
-        while (true)
-        {
-            sheet_name_ = xlsxioread_sheetlist_next(sheet_list_);
-            if (sheet_name_ == nullptr)
-            {
-                break;
-            }
-            if (strcmp(sheet_name_, rhs.sheet_name_) == 0)
-            {
-                break;
-            }
-        };
-
-        if (sheet_name_ == nullptr)
-        {
-            // end of sheets
-            xlsxioread_sheetlist_close(sheet_list_);
-            sheet_list_ = nullptr;
-            xlsxioread_close(xlsxioread_);
-            xlsxioread_ = nullptr;
-            return *this;
-        }
-
-        current_sheet_ = {content_, sheet_name_};
+        return *this;
     }
-    return *this;
-} // -----  end of method XLS_File::sheet_itor::operator =  -----
 
-XLS_File::sheet_itor &XLS_File::sheet_itor::operator=(sheet_itor &&rhs)
-{
-    if (&rhs != this)
+    if (auto next_sheet = current_sheet_.sheet_index_ + 1; next_sheet < current_sheet_.workbook_->SheetCount())
     {
-        if (sheet_list_ != nullptr)
-        {
-            xlsxioread_sheetlist_close(sheet_list_);
-            sheet_list_ = nullptr;
-        }
-        if (xlsxioread_ != nullptr)
-        {
-            xlsxioread_close(xlsxioread_);
-            xlsxioread_ = nullptr;
-        }
-        sheet_name_ = nullptr;
-        current_sheet_ = {};
-
-        content_ = rhs.content_;
-        sheet_name_ = rhs.sheet_name_;
-        xlsxioread_ = rhs.xlsxioread_;
-        sheet_list_ = rhs.sheet_list_;
-        current_sheet_ = std::move(rhs.current_sheet_);
-
-        rhs.content_ = nullptr;
-        rhs.sheet_name_ = nullptr;
-        rhs.xlsxioread_ = nullptr;
-        rhs.sheet_list_ = nullptr;
+        current_sheet_.sheet_index_ = next_sheet;
     }
-    return *this;
-} // -----  end of method XLS_File::sheet_itor::operator =  -----
-
-XLS_File::sheet_itor &XLS_File::sheet_itor::operator++()
-{
-    sheet_name_ = xlsxioread_sheetlist_next(sheet_list_);
-    if (sheet_name_ == nullptr)
+    else
     {
-        xlsxioread_sheetlist_close(sheet_list_);
-        sheet_list_ = nullptr;
-        xlsxioread_close(xlsxioread_);
-        xlsxioread_ = nullptr;
+        // end of sheets
         current_sheet_ = {};
-        return *this;
     }
-
-    current_sheet_ = {content_, sheet_name_};
     return *this;
 } // -----  end of method XLS_File::sheet_itor::operator++  -----
 
@@ -381,101 +370,38 @@ XLS_File::sheet_itor &XLS_File::sheet_itor::operator++()
 //      Method:  XLS_Sheet
 // Description:  constructor
 //--------------------------------------------------------------------------------------
-XLS_Sheet::XLS_Sheet(const std::vector<char> *content, const XLSXIOCHAR *sheet_name)
-    : content_{content}, sheet_name_mc_{sheet_name}
+XLS_Sheet::XLS_Sheet(std::shared_ptr<XLS_Workbook> workbook, std::size_t sheet_index)
+    : workbook_{std::move(workbook)}, sheet_index_{sheet_index}
 {
-    rng::transform(sheet_name_mc_, rng::back_inserter(sheet_name_lc_), [](unsigned char c) { return std::tolower(c); });
-
 } // -----  end of method XLS_Sheet::XLS_Sheet  (constructor)  -----
 
-XLS_Sheet::XLS_Sheet(const XLS_Sheet &rhs)
-    : content_{rhs.content_}, sheet_name_mc_{rhs.sheet_name_mc_}, extended_sheet_name_{rhs.extended_sheet_name_},
-      sheet_name_lc_{rhs.sheet_name_lc_}
+const std::string &XLS_Sheet::GetSheetName() const
 {
-} // -----  end of method XLS_Sheet::XLS_Sheet  (constructor)  -----
-
-XLS_Sheet::XLS_Sheet(XLS_Sheet &&rhs) noexcept
-    : content_{rhs.content_}, extended_sheet_name_{std::move(rhs.extended_sheet_name_)},
-      sheet_name_mc_{std::move(rhs.sheet_name_mc_)}, sheet_name_lc_{std::move(rhs.sheet_name_lc_)}
-{
-    rhs.content_ = nullptr;
-
-} // -----  end of method XLS_Sheet::XLS_Sheet  (constructor)  -----
-
-XLS_Sheet &XLS_Sheet::operator=(const XLS_Sheet &rhs)
-{
-    if (&rhs != this)
-    {
-        content_ = rhs.content_;
-        extended_sheet_name_ = rhs.extended_sheet_name_;
-        sheet_name_mc_ = rhs.sheet_name_mc_;
-        sheet_name_lc_ = rhs.sheet_name_lc_;
-    }
-    return *this;
-} // -----  end of method XLS_Sheet::operator =  -----
-
-XLS_Sheet &XLS_Sheet::operator=(XLS_Sheet &&rhs)
-{
-    if (&rhs != this)
-    {
-        content_ = rhs.content_;
-        extended_sheet_name_ = std::move(rhs.extended_sheet_name_);
-        sheet_name_mc_ = std::move(rhs.sheet_name_mc_);
-        sheet_name_lc_ = std::move(rhs.sheet_name_lc_);
-
-        rhs.content_ = nullptr;
-    }
-    return *this;
-} // -----  end of method XLS_Sheet::operator =  -----
+    static const std::string no_name;
+    return workbook_ ? workbook_->GetSheetName(sheet_index_) : no_name;
+} // -----  end of method XLS_Sheet::GetSheetName  -----
 
 const std::string &XLS_Sheet::GetSheetNameFromInside() const
 {
-    // we need to go and read the cells from our sheet
-    // and get the content of the first cell.
+    // the content of the first cell of our sheet. the workbook reads
+    // it once and keeps it.
 
-    if (!extended_sheet_name_.empty())
-    {
-        // use cached result
-
-        return extended_sheet_name_;
-    }
-
-    auto file_closer = [](xlsxioreader file) { xlsxioread_close(file); };
-    std::unique_ptr<xlsxio_read_struct, std::function<void(xlsxioreader)>> xlsxioread{
-        xlsxioread_open_memory(const_cast<char *>(content_->data()), content_->size(), 0), file_closer};
-
-    auto sheet_closer = [](xlsxioreadersheet sheet_reader) { xlsxioread_sheet_close(sheet_reader); };
-
-    if (xlsxioread && !sheet_name_mc_.empty())
-    {
-        std::unique_ptr<xlsxio_read_sheet_struct, std::function<void(xlsxioreadersheet)>> temp_sheet = {
-            xlsxioread_sheet_open(xlsxioread.get(), sheet_name_mc_.c_str(), 0), sheet_closer};
-        if (temp_sheet)
-        {
-            row_itor itor{content_, sheet_name_mc_};
-            if (itor != row_itor{})
-            {
-                // tab delimited content
-                std::string first_row = *itor;
-                if (!first_row.empty())
-                {
-                    extended_sheet_name_ = first_row.substr(0, first_row.find('\t'));
-                    extended_sheet_name_ |= rng::actions::transform([](unsigned char c) { return std::tolower(c); });
-                }
-            }
-        }
-    }
-    return extended_sheet_name_;
+    static const std::string no_name;
+    return workbook_ ? workbook_->GetSheetTitle(sheet_index_) : no_name;
 } // -----  end of method XLS_Sheet::GetSheetNameFromInside  -----
 
 XLS_Sheet::iterator XLS_Sheet::begin()
 {
-    return {content_, sheet_name_mc_};
+    return std::as_const(*this).begin();
 } // -----  end of method XLS_Sheet::begin  -----
 
 XLS_Sheet::const_iterator XLS_Sheet::begin() const
 {
-    return {content_, sheet_name_mc_};
+    if (!workbook_)
+    {
+        return {};
+    }
+    return row_itor{&workbook_->GetSheetCells(sheet_index_)};
 } // -----  end of method XLS_Sheet::begin  -----
 
 XLS_Sheet::iterator XLS_Sheet::end()
@@ -493,180 +419,32 @@ XLS_Sheet::const_iterator XLS_Sheet::end() const
 //      Method:  XLS_Sheet::row_itor
 // Description:  constructor
 //--------------------------------------------------------------------------------------
-XLS_Sheet::row_itor::row_itor(const std::vector<char> *content, const std::string &sheet_name)
-    : content_{content}, sheet_name_mc_{sheet_name}
+XLS_Sheet::row_itor::row_itor(const XLS_SheetCells *sheet_cells) : sheet_cells_{sheet_cells}
 {
-    if (content == nullptr || sheet_name.empty())
-    {
-        content_ = nullptr;
-        sheet_name_mc_ = {};
-        return;
-    }
-    xlsxioread_ = xlsxioread_open_memory(const_cast<char *>(content_->data()), content_->size(), 0);
+    // an empty sheet starts at the end.
 
-    if (xlsxioread_ == nullptr)
+    if (sheet_cells_ == nullptr || sheet_cells_->RowCount() == 0)
     {
-        content_ = nullptr;
-        sheet_name_mc_ = {};
+        sheet_cells_ = nullptr;
         return;
     }
-
-    current_sheet_ = xlsxioread_sheet_open(xlsxioread_, sheet_name_mc_.c_str(), 0);
-    if (current_sheet_ == nullptr)
-    {
-        xlsxioread_close(xlsxioread_);
-        xlsxioread_ = nullptr;
-        content_ = nullptr;
-        sheet_name_mc_ = {};
-        return;
-    }
-
-    this->operator++();
-
-} // -----  end of method XLS_Sheet::row_itor::row_itor  (constructor)  -----
-
-XLS_Sheet::row_itor::row_itor(const row_itor &rhs) : row_itor(rhs.content_, rhs.sheet_name_mc_)
-{
-    while (current_row_ != rhs.current_row_)
-    {
-        this->operator++();
-    }
-} // -----  end of method XLS_Sheet::row_itor::row_itor  (constructor)  -----
-
-XLS_Sheet::row_itor::row_itor(row_itor &&rhs) noexcept
-    : content_{rhs.content_}, xlsxioread_{rhs.xlsxioread_}, current_sheet_{rhs.current_sheet_},
-      sheet_name_mc_{std::move(rhs.sheet_name_mc_)}, current_row_{std::move(rhs.current_row_)}
-{
-    rhs.content_ = nullptr;
-    rhs.xlsxioread_ = nullptr;
-    rhs.current_sheet_ = nullptr;
-
+    row_ = XLS_Row{sheet_cells_->Row(current_row_)};
 } // -----  end of method XLS_Sheet::row_itor::row_itor  (constructor)  -----
 
-XLS_Sheet::row_itor::~row_itor()
-{
-    if (current_sheet_ != nullptr)
-    {
-        xlsxioread_sheet_close(current_sheet_);
-    }
-    if (xlsxioread_ != nullptr)
-    {
-        xlsxioread_close(xlsxioread_);
-    }
-
-} // -----  end of method XLS_Sheet::XLS_Sheet  (destructor)  -----
-
-XLS_Sheet::row_itor &XLS_Sheet::row_itor::operator=(const row_itor &rhs)
-{
-    if (&rhs != this)
-    {
-        if (current_sheet_ != nullptr)
-        {
-            xlsxioread_sheet_close(current_sheet_);
-            current_sheet_ = nullptr;
-        }
-        if (xlsxioread_ != nullptr)
-        {
-            xlsxioread_close(xlsxioread_);
-            xlsxioread_ = nullptr;
-        }
-        current_row_.clear();
-        content_ = rhs.content_;
-        sheet_name_mc_ = rhs.sheet_name_mc_;
-
-        xlsxioread_ = xlsxioread_open_memory(const_cast<char *>(content_->data()), content_->size(), 0);
-
-        if (xlsxioread_ == nullptr || sheet_name_mc_.empty())
-        {
-            xlsxioread_close(xlsxioread_);
-            xlsxioread_ = nullptr;
-            return *this;
-        }
-        current_sheet_ = xlsxioread_sheet_open(xlsxioread_, sheet_name_mc_.c_str(), 0);
-        if (current_sheet_ == nullptr)
-        {
-            xlsxioread_close(xlsxioread_);
-            xlsxioread_ = nullptr;
-            sheet_name_mc_ = {};
-            return *this;
-        }
-        // we need to match up to the rhs
-        //
-        while (current_row_ != rhs.current_row_)
-        {
-            this->operator++();
-        }
-    }
-    return *this;
-}
-
-XLS_Sheet::row_itor &XLS_Sheet::row_itor::operator=(row_itor &&rhs) noexcept
-{
-    if (&rhs != this)
-    {
-        if (current_sheet_ != nullptr)
-        {
-            xlsxioread_sheet_close(current_sheet_);
-            current_sheet_ = nullptr;
-        }
-        if (xlsxioread_ != nullptr)
-        {
-            xlsxioread_close(xlsxioread_);
-            xlsxioread_ = nullptr;
-        }
-
-        content_ = rhs.content_;
-        xlsxioread_ = rhs.xlsxioread_;
-        current_sheet_ = rhs.current_sheet_;
-        sheet_name_mc_ = std::move(rhs.sheet_name_mc_);
-        current_row_ = std::move(rhs.current_row_);
-
-        rhs.content_ = nullptr;
-        rhs.xlsxioread_ = nullptr;
-        rhs.current_sheet_ = nullptr;
-    }
-    return *this;
-}
-
 XLS_Sheet::row_itor &XLS_Sheet::row_itor::operator++()
 {
-    if (current_sheet_ == nullptr)
+    if (sheet_cells_ == nullptr)
     {
         return *this;
     }
 
-    auto got_row = xlsxioread_sheet_next_row(current_sheet_);
-    if (!got_row)
+    if (++current_row_ == sheet_cells_->RowCount())
     {
-        xlsxioread_sheet_close(current_sheet_);
-        current_sheet_ = nullptr;
-        xlsxioread_close(xlsxioread_);
-        xlsxioread_ = nullptr;
-        content_ = nullptr;
-        current_row_.clear();
-        sheet_name_mc_ = {};
+        sheet_cells_ = nullptr;
+        current_row_ = 0;
+        row_ = {};
         return *this;
     }
-
-    current_row_.clear();
-
-    // let's build this just once
-    auto cell_deleter = [](XLSXIOCHAR *cell) {
-        if (cell)
-            free(cell);
-    };
-
-    while (true)
-    {
-        std::unique_ptr<XLSXIOCHAR, std::function<void(XLSXIOCHAR *)>> next_cell = {
-            xlsxioread_sheet_next_cell(current_sheet_), cell_deleter};
-        if (!next_cell)
-        {
-            break;
-        }
-        current_row_ += next_cell.get();
-        current_row_ += '\t';
-    }
-    current_row_ += '\n';
+    row_ = XLS_Row{sheet_cells_->Row(current_row_)};
     return *this;
 } // -----  end of method XLS_Sheet::row_itor::operator++  -----
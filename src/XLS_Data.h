@@ -24,12 +24,157 @@
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "Extractor.h"
 
 class XLS_Sheet;
-class XLS_Row;
+
+// =====================================================================================
+//        Class:  XLS_SheetCells
+//  Description:  all the cells of 1 sheet. the text of every cell is kept back to
+//                back in 1 buffer and cells are views into it so reading a sheet
+//                costs a few allocations, not 1 per cell.
+// =====================================================================================
+
+struct XLS_SheetCells
+{
+    // a vector, not a string, so moving us can't move the text out from
+    // under the views. for the same reason, no copies.
+
+    XLS_SheetCells() = default;
+    XLS_SheetCells(const XLS_SheetCells &rhs) = delete;
+    XLS_SheetCells(XLS_SheetCells &&rhs) noexcept = default;
+
+    XLS_SheetCells &operator=(const XLS_SheetCells &rhs) = delete;
+    XLS_SheetCells &operator=(XLS_SheetCells &&rhs) noexcept = default;
+
+    std::vector<char> text_;
+    std::vector<std::string_view> cells_;
+
+    // index of each row's first cell with 1 more entry for the end of the last row.
+
+    std::vector<std::size_t> row_starts_;
+
+    [[nodiscard]] std::size_t RowCount() const
+    {
+        return row_starts_.empty() ? 0 : row_starts_.size() - 1;
+    }
+    [[nodiscard]] std::span<const std::string_view> Row(std::size_t row) const
+    {
+        return {cells_.data() + row_starts_[row], row_starts_[row + 1] - row_starts_[row]};
+    }
+};
+
+// =====================================================================================
+//        Class:  XLS_Row
+//  Description:  the cells of 1 row. only valid while its workbook is.
+// =====================================================================================
+
+class XLS_Row
+{
+public:
+    XLS_Row() = default;
+    explicit XLS_Row(std::span<const std::string_view> cells) : cells_{cells}
+    {
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return cells_.size();
+    }
+    [[nodiscard]] bool empty() const
+    {
+        return cells_.empty();
+    }
+    [[nodiscard]] std::string_view operator[](std::size_t cell) const
+    {
+        return cells_[cell];
+    }
+    [[nodiscard]] auto begin() const
+    {
+        return cells_.begin();
+    }
+    [[nodiscard]] auto end() const
+    {
+        return cells_.end();
+    }
+
+    // the row as text: each cell followed by a tab and a newline at the end.
+
+    [[nodiscard]] std::string Text() const;
+
+private:
+    std::span<const std::string_view> cells_;
+};
+
+// =====================================================================================
+//        Class:  XLS_Workbook
+//  Description:  owns the XLS data and the 1 xlsxio reader opened on it.
+//                sheet names are read when we open the workbook. each sheet's
+//                title (first cell of first row) and its rows are read the first
+//                time they're asked for and kept so nothing is unzipped twice.
+//
+//                caches fill in from const methods so a workbook must not be
+//                shared across threads.
+// =====================================================================================
+
+class XLS_Workbook
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    explicit XLS_Workbook(std::vector<char> &&content);
+    XLS_Workbook(const XLS_Workbook &rhs) = delete;
+    XLS_Workbook(XLS_Workbook &&rhs) = delete;
+
+    ~XLS_Workbook();
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] bool empty() const
+    {
+        return content_.empty();
+    }
+    [[nodiscard]] std::size_t SheetCount() const
+    {
+        return sheets_.size();
+    }
+
+    // names and titles are lower case.
+
+    const std::string &GetSheetName(std::size_t sheet) const;
+    const std::string &GetSheetTitle(std::size_t sheet) const;
+    const XLS_SheetCells &GetSheetCells(std::size_t sheet) const;
+
+    // ====================  OPERATORS     =======================================
+
+    XLS_Workbook &operator=(const XLS_Workbook &rhs) = delete;
+    XLS_Workbook &operator=(XLS_Workbook &&rhs) = delete;
+
+private:
+    // ====================  METHODS       =======================================
+
+    XLS_SheetCells ReadCells(std::size_t sheet, std::size_t max_rows) const;
+
+    // ====================  DATA MEMBERS  =======================================
+
+    struct SheetInfo
+    {
+        std::string name_mc_;
+        std::string name_lc_;
+        mutable std::optional<std::string> title_;
+        mutable std::optional<XLS_SheetCells> cells_;
+    };
+
+    std::vector<char> content_;
+    xlsxioreader xlsxioread_ = nullptr;
+    std::vector<SheetInfo> sheets_;
+
+}; // -----  end of class XLS_Workbook  -----
 
 // =====================================================================================
 //        Class:  XLS_File
@@ -75,7 +220,7 @@ public:
 
     [[nodiscard]] bool empty() const
     {
-        return content_.empty();
+        return !workbook_ || workbook_->empty();
     }
 
     std::vector<std::string> GetSheetNames(void) const;
@@ -100,7 +245,9 @@ private:
 
     // ====================  DATA MEMBERS  =======================================
 
-    std::vector<char> content_;
+    // copies of an XLS_File and the sheets we hand out all share 1 workbook.
+
+    std::shared_ptr<XLS_Workbook> workbook_;
 
 }; // -----  end of class XLS_File  -----
 
@@ -113,13 +260,13 @@ class XLS_Sheet
 public:
     class row_itor;
 
-    using value_type = std::string;
+    using value_type = XLS_Row;
 
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
-    using reference = value_type &;
-    using const_reference = value_type &;
-    using pointer = value_type *;
+    using reference = const value_type &;
+    using const_reference = const value_type &;
+    using pointer = const value_type *;
     using const_pointer = value_type const *;
     using iterator = row_itor;
     using const_iterator = const row_itor;
@@ -128,10 +275,10 @@ public:
     // ====================  LIFECYCLE     =======================================
 
     XLS_Sheet() = default; // constructor
-    XLS_Sheet(const std::vector<char> *content, const XLSXIOCHAR *sheet_name);
+    XLS_Sheet(std::shared_ptr<XLS_Workbook> workbook, std::size_t sheet_index);
 
-    XLS_Sheet(const XLS_Sheet &rhs);
-    XLS_Sheet(XLS_Sheet &&rhs) noexcept;
+    XLS_Sheet(const XLS_Sheet &rhs) = default;
+    XLS_Sheet(XLS_Sheet &&rhs) noexcept = default;
 
     ~XLS_Sheet() = default;
 
@@ -144,25 +291,22 @@ public:
 
     [[nodiscard]] bool empty() const
     {
-        return sheet_name_lc_.empty();
+        return !workbook_;
     }
 
-    const std::string &GetSheetName() const
-    {
-        return sheet_name_lc_;
-    }
+    const std::string &GetSheetName() const;
     const std::string &GetSheetNameFromInside() const;
 
     // ====================  MUTATORS      =======================================
 
     // ====================  OPERATORS     =======================================
 
-    XLS_Sheet &operator=(const XLS_Sheet &rhs);
-    XLS_Sheet &operator=(XLS_Sheet &&rhs);
+    XLS_Sheet &operator=(const XLS_Sheet &rhs) = default;
+    XLS_Sheet &operator=(XLS_Sheet &&rhs) noexcept = default;
 
     bool operator==(const XLS_Sheet &rhs) const
     {
-        return content_ == rhs.content_ && sheet_name_mc_ == rhs.sheet_name_mc_;
+        return workbook_ == rhs.workbook_ && sheet_index_ == rhs.sheet_index_;
     }
     bool operator!=(const XLS_Sheet &rhs) const
     {
@@ -175,15 +319,16 @@ protected:
     // ====================  DATA MEMBERS  =======================================
 
 private:
+    // sheet_itor steps us through the workbook's sheets.
+
+    friend class XLS_File::sheet_itor;
+
     // ====================  METHODS       =======================================
 
     // ====================  DATA MEMBERS  =======================================
 
-    const std::vector<char> *content_ = nullptr;
-
-    mutable std::string extended_sheet_name_;
-    mutable std::string sheet_name_lc_;
-    mutable std::string sheet_name_mc_;
+    std::shared_ptr<XLS_Workbook> workbook_;
+    std::size_t sheet_index_ = 0;
 
 }; // -----  end of class XLS_Sheet  -----
 
@@ -208,12 +353,12 @@ public:
     // ====================  LIFECYCLE     =======================================
 
     sheet_itor() = default; // constructor
-    sheet_itor(const std::vector<char> *content);
+    explicit sheet_itor(std::shared_ptr<XLS_Workbook> workbook);
 
-    sheet_itor(const sheet_itor &rhs);
-    sheet_itor(sheet_itor &&rhs) noexcept;
+    sheet_itor(const sheet_itor &rhs) = default;
+    sheet_itor(sheet_itor &&rhs) noexcept = default;
 
-    ~sheet_itor();
+    ~sheet_itor() = default;
 
     // ====================  ACCESSORS     =======================================
 
@@ -229,12 +374,12 @@ public:
 
     // ====================  OPERATORS     =======================================
 
-    sheet_itor &operator=(const sheet_itor &rhs);
-    sheet_itor &operator=(sheet_itor &&rhs);
+    sheet_itor &operator=(const sheet_itor &rhs) = default;
+    sheet_itor &operator=(sheet_itor &&rhs) noexcept = default;
 
     bool operator==(const sheet_itor &rhs) const
     {
-        return sheet_list_ == rhs.sheet_list_ && sheet_name_ == rhs.sheet_name_;
+        return current_sheet_ == rhs.current_sheet_;
     }
     bool operator!=(const sheet_itor &rhs) const
     {
@@ -268,11 +413,7 @@ private:
 
     // ====================  DATA MEMBERS  =======================================
 
-    const std::vector<char> *content_ = nullptr;
-    const XLSXIOCHAR *sheet_name_ = nullptr;
-
-    xlsxioreader xlsxioread_ = nullptr;
-    xlsxioreadersheetlist sheet_list_ = nullptr;
+    // an empty sheet marks the end.
 
     mutable XLS_Sheet current_sheet_;
 
@@ -281,28 +422,30 @@ private:
 // =====================================================================================
 //        Class:  XLS_Sheet::row_itor
 //  Description:  extracts value pairs from the XLS sheet data
+//                a cursor into the cells the workbook has already read so
+//                copying one is cheap.
 // =====================================================================================
 class XLS_Sheet::row_itor
 {
 public:
     using iterator_category = std::forward_iterator_tag;
-    using value_type = std::string;
+    using value_type = XLS_Row;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
-    using reference = value_type &;
-    using const_reference = value_type &;
-    using pointer = value_type *;
+    using reference = const value_type &;
+    using const_reference = const value_type &;
+    using pointer = const value_type *;
     using const_pointer = const value_type *;
 
 public:
     // ====================  LIFECYCLE     =======================================
     row_itor() = default; // constructor
-    row_itor(const std::vector<char> *content, const std::string &sheet_name);
+    explicit row_itor(const XLS_SheetCells *sheet_cells);
 
-    row_itor(const row_itor &rhs);
-    row_itor(row_itor &&rhs) noexcept;
+    row_itor(const row_itor &rhs) = default;
+    row_itor(row_itor &&rhs) noexcept = default;
 
-    ~row_itor();
+    ~row_itor() = default;
 
     // ====================  ACCESSORS     =======================================
 
@@ -318,33 +461,27 @@ public:
 
     // ====================  OPERATORS     =======================================
 
-    row_itor &operator=(const row_itor &rhs);
-    row_itor &operator=(row_itor &&rhs) noexcept;
+    row_itor &operator=(const row_itor &rhs) = default;
+    row_itor &operator=(row_itor &&rhs) noexcept = default;
 
     bool operator==(const row_itor &rhs) const
     {
-        return current_sheet_ == rhs.current_sheet_ && current_row_ == rhs.current_row_;
+        return sheet_cells_ == rhs.sheet_cells_ && current_row_ == rhs.current_row_;
     }
     bool operator!=(const row_itor &rhs) const
     {
         return !(*this == rhs);
     }
 
-    reference operator*()
-    {
-        return current_row_;
-    }
+    // the end iterator reads as an empty row, as it always has.
+
     const_reference operator*() const
     {
-        return current_row_;
-    }
-    pointer operator->()
-    {
-        return &current_row_;
+        return row_;
     }
     const_pointer operator->() const
     {
-        return &current_row_;
+        return &row_;
     }
 
 protected:
@@ -357,12 +494,9 @@ private:
 
     // ====================  DATA MEMBERS  =======================================
 
-    const std::vector<char> *content_ = nullptr;
-    xlsxioreader xlsxioread_ = nullptr;
-    xlsxioreadersheet current_sheet_ = nullptr;
-
-    mutable std::string sheet_name_mc_;
-    mutable std::string current_row_;
+    const XLS_SheetCells *sheet_cells_ = nullptr;
+    std::size_t current_row_ = 0;
+    XLS_Row row_;
 
 }; // -----  end of class XLS_Sheet::row_itor  -----
 
@@ -0,0 +1,304 @@
+// =====================================================================================
+//
+//       Filename:  uudecode_check.cpp
+//
+//    Description:  checks UUDecode against the uudecode program on random input
+//                  and times it.
+//
+//        Version:  1.0
+//        Created:  10/17/2026 07:48:12 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//
+// =====================================================================================
+
+/* This file is part of Extractor_Markup. */
+
+/* Extractor_Markup is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* Extractor_Markup is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with Extractor_Markup.  If not, see <http://www.gnu.org/licenses/>. */
+
+// each case is a random payload encoded with a random mix of what we see in
+// filings: full 45 byte lines or odd lengths, '`' or ' ' for zero, trailing
+// blanks trimmed, CRLF line ends and text ahead of the 'begin' line. the
+// encoded file is run through the reference program and UUDecode and the
+// results must match byte for byte. a failing case is left on disk.
+//
+// with --bench-MB, times UUDecode on that much data against a plain copy of
+// the encoded text and 1 run of the reference program.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "Extractor_Utils.h"
+#include "UUDecode.h"
+
+namespace po = boost::program_options;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+struct EncodeOptions
+{
+    bool odd_line_lengths_ = false;
+    bool blank_for_zero_ = false;
+    bool trim_lines_ = false;
+    bool crlf_ = false;
+    bool leading_text_ = false;
+};
+
+char EncodeChar(int value, bool blank_for_zero)
+{
+    return static_cast<char>(value == 0 && !blank_for_zero ? '`' : value + ' ');
+}
+
+std::string UUEncode(const std::string &payload, const EncodeOptions &options, std::mt19937 &random)
+{
+    const std::string line_end{options.crlf_ ? "\r\n" : "\n"};
+    auto end_line = [&](std::string &encoded, std::string &line) {
+        if (options.trim_lines_)
+        {
+            line.erase(line.find_last_not_of(' ') + 1);
+        }
+        encoded += line;
+        encoded += line_end;
+        line.clear();
+    };
+
+    std::string encoded;
+    if (options.leading_text_)
+    {
+        encoded += "<TEXT>" + line_end;
+    }
+    encoded += "begin 644 check.xlsx" + line_end;
+
+    std::string line;
+    for (size_t i = 0; i < payload.size();)
+    {
+        const size_t wanted = options.odd_line_lengths_ ? 1 + random() % 45 : 45;
+        const size_t length = std::min(wanted, payload.size() - i);
+        line += EncodeChar(static_cast<int>(length), options.blank_for_zero_);
+        for (size_t j = 0; j < length; j += 3)
+        {
+            auto byte_at = [&](size_t k) -> unsigned {
+                return j + k < length ? static_cast<uint8_t>(payload[i + j + k]) : 0;
+            };
+            const unsigned bits = (byte_at(0) << 16) | (byte_at(1) << 8) | byte_at(2);
+            for (int shift = 18; shift >= 0; shift -= 6)
+            {
+                line += EncodeChar(static_cast<int>((bits >> shift) & 0x3F), options.blank_for_zero_);
+            }
+        }
+        end_line(encoded, line);
+        i += length;
+    }
+    line += EncodeChar(0, options.blank_for_zero_);
+    end_line(encoded, line);
+    encoded += "end" + line_end;
+    return encoded;
+}
+
+std::string RunReference(const std::string &reference, const fs::path &encoded_file)
+{
+    const auto command = catenate(reference, " '", encoded_file.string(), "'");
+    FILE *output = popen(command.c_str(), "r");
+    if (output == nullptr)
+    {
+        throw std::runtime_error(catenate("Can't run: ", command));
+    }
+    std::string result;
+    std::array<char, 64 * 1024> buffer{};
+    while (auto count = fread(buffer.data(), 1, buffer.size(), output))
+    {
+        result.append(buffer.data(), count);
+    }
+    if (pclose(output) != 0)
+    {
+        throw std::runtime_error(catenate("Failed: ", command));
+    }
+    return result;
+}
+
+void WriteFile(const fs::path &file_name, const std::string &content)
+{
+    std::ofstream file{file_name, std::ios::out | std::ios::binary | std::ios::trunc};
+    file.write(content.data(), content.size());
+    if (!file)
+    {
+        throw std::runtime_error(catenate("Can't write: ", file_name.string()));
+    }
+}
+
+std::string RandomPayload(size_t size, std::mt19937 &random)
+{
+    std::string payload(size, '\0');
+    std::ranges::generate(payload, [&random]() { return static_cast<char>(random()); });
+    return payload;
+}
+
+int CheckAgainstReference(int cases, unsigned seed, const std::string &reference, const fs::path &work_directory)
+{
+    std::mt19937 random{seed};
+    const auto encoded_file = work_directory / "uudecode_check.uu";
+
+    for (int i = 0; i < cases; ++i)
+    {
+        // mostly small payloads, some the size of a real workbook.
+
+        const size_t size = i % 50 == 0 ? random() % (512 * 1024) : random() % 5000;
+        const auto payload = RandomPayload(size, random);
+
+        EncodeOptions options;
+        options.odd_line_lengths_ = random() % 4 == 0;
+        options.blank_for_zero_ = random() % 2 == 0;
+        options.trim_lines_ = options.blank_for_zero_ && random() % 2 == 0;
+        options.crlf_ = random() % 4 == 0;
+        options.leading_text_ = random() % 4 == 0;
+
+        const auto encoded = UUEncode(payload, options, random);
+        WriteFile(encoded_file, encoded);
+
+        const auto expected = RunReference(reference, encoded_file);
+        const auto decoded = UUDecode(encoded);
+        if (expected.size() != decoded.size() || !std::equal(decoded.begin(), decoded.end(), expected.begin()))
+        {
+            std::cerr << catenate("Case: ", i, " (seed ", seed, ") differs. payload: ", size,
+                                  " bytes. reference: ", expected.size(), " UUDecode: ", decoded.size(),
+                                  ". odd lines: ", options.odd_line_lengths_, " blank zero: ", options.blank_for_zero_,
+                                  " trimmed: ", options.trim_lines_, " CRLF: ", options.crlf_,
+                                  " leading text: ", options.leading_text_, ". input left in: ", encoded_file.string())
+                      << '\n';
+            return 1;
+        }
+        if (expected != payload)
+        {
+            std::cerr << catenate("Case: ", i, " (seed ", seed, ") reference doesn't round trip. input left in: ",
+                                  encoded_file.string())
+                      << '\n';
+            return 1;
+        }
+    }
+    fs::remove(encoded_file);
+    std::cout << catenate("UUDecode matches '", reference, "' on ", cases, " cases. seed: ", seed) << '\n';
+    return 0;
+}
+
+template <typename Function>
+double BestSeconds(int runs, Function function)
+{
+    double best{1e9};
+    for (int i = 0; i < runs; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int Benchmark(int megabytes, unsigned seed, const std::string &reference, const fs::path &work_directory)
+{
+    std::mt19937 random{seed};
+    const auto payload = RandomPayload(static_cast<size_t>(megabytes) * 1024 * 1024, random);
+    const auto encoded = UUEncode(payload, {}, random);
+    const double encoded_MB = static_cast<double>(encoded.size()) / (1024 * 1024);
+
+    // both write to fresh memory like a decode does.
+
+    const double decode_seconds = BestSeconds(5, [&encoded]() {
+        auto decoded = UUDecode(encoded);
+        if (decoded.empty())
+        {
+            throw std::runtime_error("nothing decoded");
+        }
+    });
+    const double copy_seconds = BestSeconds(5, [&encoded]() {
+        std::vector<char> copy(encoded.size());
+        std::memcpy(copy.data(), encoded.data(), encoded.size());
+        if (copy.back() != encoded.back())
+        {
+            throw std::runtime_error("bad copy");
+        }
+    });
+
+    const auto encoded_file = work_directory / "uudecode_check.uu";
+    WriteFile(encoded_file, encoded);
+    const double reference_seconds = BestSeconds(1, [&]() { RunReference(reference, encoded_file); });
+    fs::remove(encoded_file);
+
+    std::cout << std::format("encoded input: {:.1f} MB\n", encoded_MB);
+    std::cout << std::format("UUDecode:  {:8.1f} MB/s\n", encoded_MB / decode_seconds);
+    std::cout << std::format("copy:      {:8.1f} MB/s\n", encoded_MB / copy_seconds);
+    std::cout << std::format("reference: {:8.1f} MB/s (includes writing the file and starting the program)\n",
+                             encoded_MB / reference_seconds);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, const char *argv[])
+{
+    int cases{2000};
+    unsigned seed{std::random_device{}()};
+    int bench_MB{0};
+    std::string reference;
+    std::string work_directory;
+
+    po::options_description options{"uudecode_check options"};
+    options.add_options()("help,h", "produce help message")(
+        "cases", po::value<int>(&cases)->default_value(2000), "number of random cases to check")(
+        "seed", po::value<unsigned>(&seed), "seed for the random cases. default is random")(
+        "reference", po::value<std::string>(&reference)->default_value("uudecode -o /dev/stdout"),
+        "program to check against. the encoded file name is added to the end")(
+        "work-dir", po::value<std::string>(&work_directory)->default_value(fs::temp_directory_path().string()),
+        "where to write the encoded files")(
+        "bench-MB", po::value<int>(&bench_MB)->default_value(0), "time decoding this many MB instead of checking");
+
+    try
+    {
+        po::variables_map variable_map;
+        po::store(po::parse_command_line(argc, argv, options), variable_map);
+        po::notify(variable_map);
+        if (variable_map.count("help") != 0)
+        {
+            std::cout << options << '\n';
+            return 0;
+        }
+
+        if (bench_MB > 0)
+        {
+            return Benchmark(bench_MB, seed, reference, work_directory);
+        }
+        return CheckAgainstReference(cases, seed, reference, work_directory);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Problem: " << e.what() << '\n';
+    }
+    return 1;
+}